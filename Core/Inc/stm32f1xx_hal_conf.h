@@ -76,6 +76,7 @@
 #define HAL_GPIO_MODULE_ENABLED
 #define HAL_PWR_MODULE_ENABLED
 #define HAL_RCC_MODULE_ENABLED
+#define HAL_TIM_MODULE_ENABLED
 
 /* ########################## Oscillator Values adaptation ####################*/
 /**
@@ -51,7 +51,6 @@ void HardFault_Handler(void);
 void MemManage_Handler(void);
 void BusFault_Handler(void);
 void UsageFault_Handler(void);
-void SVC_Handler(void);
 void DebugMon_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
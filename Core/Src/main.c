@@ -115,12 +115,8 @@ int main(void)
   SystemClock_Config();
   MX_GPIO_Init();
 
-  MIROS_Sched();
-
-  /**
-   * This part shouldn't be reachable if OS is working correctly
-   * */
-  assert_param(0);
+  /*  2. start MiROS, launches the first task and doesn't return  */
+  MIROS_Start();
 
   /* USER CODE END 2 */
 
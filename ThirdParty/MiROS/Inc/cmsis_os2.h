@@ -0,0 +1,364 @@
+/******************************************************************************
+ * @file    cmsis_os2.h
+ * @brief   CMSIS-RTOS2 API, implemented on top of MiROS
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_CMSIS_OS2_H_
+#define _INC_CMSIS_OS2_H_
+
+/**
+ * The subset of CMSIS-RTOS2 (API version 2.1) implemented by MiROS
+ * (cmsis_os2.c): kernel, threads, delays, timers, event flags, mutexes,
+ * semaphores, memory pools and message queues. The types, constants and
+ * function prototypes match ARM's `cmsis_os2.h`, so middleware written
+ * against CMSIS-RTOS2 builds unmodified.
+ *
+ * MiROS doesn't allocate memory from a heap: an object's control block
+ * (and threads' stacks, memory pools' and message queues' storage) is
+ * either given in its attributes (`cb_mem`, `stack_mem`, `mp_mem`,
+ * `mq_mem`), sized with the types and macros in miros_os2.h, or taken from
+ * static pools sized at compile time (#MIROS_OS2_MAX_THREADS, ...) when the
+ * attributes, or their memory, are NULL. `osXxxNew()` returns NULL when the
+ * pool is exhausted.
+ * */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief API and kernel version
+ * */
+typedef struct {
+  uint32_t api;
+  uint32_t kernel;
+} osVersion_t;
+
+/**
+ * @brief Kernel state
+ * */
+typedef enum {
+  osKernelInactive = 0,
+  osKernelReady = 1,
+  osKernelRunning = 2,
+  osKernelLocked = 3,
+  osKernelSuspended = 4,
+  osKernelError = -1,
+  osKernelReserved = 0x7FFFFFFF
+} osKernelState_t;
+
+/**
+ * @brief Thread state
+ * */
+typedef enum {
+  osThreadInactive = 0,
+  osThreadReady = 1,
+  osThreadRunning = 2,
+  osThreadBlocked = 3,
+  osThreadTerminated = 4,
+  osThreadError = -1,
+  osThreadReserved = 0x7FFFFFFF
+} osThreadState_t;
+
+/**
+ * @brief Thread priority, mapped onto MiROS priorities (#MIROS_OS2_PRIORITY())
+ * */
+typedef enum {
+  osPriorityNone = 0,
+  osPriorityIdle = 1,
+  osPriorityLow = 8,
+  osPriorityLow1 = 8 + 1,
+  osPriorityLow2 = 8 + 2,
+  osPriorityLow3 = 8 + 3,
+  osPriorityLow4 = 8 + 4,
+  osPriorityLow5 = 8 + 5,
+  osPriorityLow6 = 8 + 6,
+  osPriorityLow7 = 8 + 7,
+  osPriorityBelowNormal = 16,
+  osPriorityBelowNormal1 = 16 + 1,
+  osPriorityBelowNormal2 = 16 + 2,
+  osPriorityBelowNormal3 = 16 + 3,
+  osPriorityBelowNormal4 = 16 + 4,
+  osPriorityBelowNormal5 = 16 + 5,
+  osPriorityBelowNormal6 = 16 + 6,
+  osPriorityBelowNormal7 = 16 + 7,
+  osPriorityNormal = 24,
+  osPriorityNormal1 = 24 + 1,
+  osPriorityNormal2 = 24 + 2,
+  osPriorityNormal3 = 24 + 3,
+  osPriorityNormal4 = 24 + 4,
+  osPriorityNormal5 = 24 + 5,
+  osPriorityNormal6 = 24 + 6,
+  osPriorityNormal7 = 24 + 7,
+  osPriorityAboveNormal = 32,
+  osPriorityAboveNormal1 = 32 + 1,
+  osPriorityAboveNormal2 = 32 + 2,
+  osPriorityAboveNormal3 = 32 + 3,
+  osPriorityAboveNormal4 = 32 + 4,
+  osPriorityAboveNormal5 = 32 + 5,
+  osPriorityAboveNormal6 = 32 + 6,
+  osPriorityAboveNormal7 = 32 + 7,
+  osPriorityHigh = 40,
+  osPriorityHigh1 = 40 + 1,
+  osPriorityHigh2 = 40 + 2,
+  osPriorityHigh3 = 40 + 3,
+  osPriorityHigh4 = 40 + 4,
+  osPriorityHigh5 = 40 + 5,
+  osPriorityHigh6 = 40 + 6,
+  osPriorityHigh7 = 40 + 7,
+  osPriorityRealtime = 48,
+  osPriorityRealtime1 = 48 + 1,
+  osPriorityRealtime2 = 48 + 2,
+  osPriorityRealtime3 = 48 + 3,
+  osPriorityRealtime4 = 48 + 4,
+  osPriorityRealtime5 = 48 + 5,
+  osPriorityRealtime6 = 48 + 6,
+  osPriorityRealtime7 = 48 + 7,
+  osPriorityISR = 56,
+  osPriorityError = -1,
+  osPriorityReserved = 0x7FFFFFFF
+} osPriority_t;
+
+/**
+ * @brief Thread and timer functions
+ * */
+typedef void (*osThreadFunc_t)(void *argument);
+typedef void (*osTimerFunc_t)(void *argument);
+
+/**
+ * @brief Timer type
+ * */
+typedef enum {
+  osTimerOnce = 0,
+  osTimerPeriodic = 1
+} osTimerType_t;
+
+/**
+ * @brief Timeout value, wait until the object is available
+ * */
+#define osWaitForever         0xFFFFFFFFU
+
+/**
+ * @brief Event flags options, and error codes returned as flags
+ * */
+#define osFlagsWaitAny        0x00000000U
+#define osFlagsWaitAll        0x00000001U
+#define osFlagsNoClear        0x00000002U
+
+#define osFlagsError          0x80000000U
+#define osFlagsErrorUnknown   0xFFFFFFFFU
+#define osFlagsErrorTimeout   0xFFFFFFFEU
+#define osFlagsErrorResource  0xFFFFFFFDU
+#define osFlagsErrorParameter 0xFFFFFFFCU
+#define osFlagsErrorISR       0xFFFFFFFAU
+
+/**
+ * @brief Thread and mutex attribute bits
+ * */
+#define osThreadDetached      0x00000000U
+#define osThreadJoinable      0x00000001U
+
+#define osMutexRecursive      0x00000001U
+#define osMutexPrioInherit    0x00000002U
+#define osMutexRobust         0x00000008U
+
+/**
+ * @brief Status code returned by most functions
+ * */
+typedef enum {
+  osOK = 0,
+  osError = -1,
+  osErrorTimeout = -2,
+  osErrorResource = -3,
+  osErrorParameter = -4,
+  osErrorNoMemory = -5,
+  osErrorISR = -6,
+  osStatusReserved = 0x7FFFFFFF
+} osStatus_t;
+
+/**
+ * @brief Object identifiers, pointers to the objects' control blocks
+ * */
+typedef void *osThreadId_t;
+typedef void *osTimerId_t;
+typedef void *osEventFlagsId_t;
+typedef void *osMutexId_t;
+typedef void *osSemaphoreId_t;
+typedef void *osMemoryPoolId_t;
+typedef void *osMessageQueueId_t;
+
+typedef uint32_t TZ_ModuleId_t;
+
+/**
+ * @brief Object attributes
+ * */
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+  void *stack_mem;
+  uint32_t stack_size;
+  osPriority_t priority;
+  TZ_ModuleId_t tz_module;
+  uint32_t reserved;
+} osThreadAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+} osTimerAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+} osEventFlagsAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+} osMutexAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+} osSemaphoreAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+  void *mp_mem;
+  uint32_t mp_size;
+} osMemoryPoolAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+  void *mq_mem;
+  uint32_t mq_size;
+} osMessageQueueAttr_t;
+
+/*  Kernel  */
+osStatus_t osKernelInitialize(void);
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf,
+    uint32_t id_size);
+osKernelState_t osKernelGetState(void);
+osStatus_t osKernelStart(void);
+uint32_t osKernelGetTickCount(void);
+uint32_t osKernelGetTickFreq(void);
+uint32_t osKernelGetSysTimerCount(void);
+uint32_t osKernelGetSysTimerFreq(void);
+
+/*  Threads  */
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument,
+    const osThreadAttr_t *attr);
+const char* osThreadGetName(osThreadId_t thread_id);
+osThreadId_t osThreadGetId(void);
+osThreadState_t osThreadGetState(osThreadId_t thread_id);
+uint32_t osThreadGetStackSize(osThreadId_t thread_id);
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority);
+osPriority_t osThreadGetPriority(osThreadId_t thread_id);
+osStatus_t osThreadYield(void);
+void osThreadExit(void) __attribute__((noreturn));
+
+/*  Delays  */
+osStatus_t osDelay(uint32_t ticks);
+osStatus_t osDelayUntil(uint32_t ticks);
+
+/*  Timers  */
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument,
+    const osTimerAttr_t *attr);
+const char* osTimerGetName(osTimerId_t timer_id);
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+osStatus_t osTimerStop(osTimerId_t timer_id);
+uint32_t osTimerIsRunning(osTimerId_t timer_id);
+osStatus_t osTimerDelete(osTimerId_t timer_id);
+
+/*  Event flags  */
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr);
+const char* osEventFlagsGetName(osEventFlagsId_t ef_id);
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id);
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags,
+    uint32_t options, uint32_t timeout);
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id);
+
+/*  Mutexes  */
+osMutexId_t osMutexNew(const osMutexAttr_t *attr);
+const char* osMutexGetName(osMutexId_t mutex_id);
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+osStatus_t osMutexRelease(osMutexId_t mutex_id);
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id);
+osStatus_t osMutexDelete(osMutexId_t mutex_id);
+
+/*  Semaphores  */
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count,
+    const osSemaphoreAttr_t *attr);
+const char* osSemaphoreGetName(osSemaphoreId_t semaphore_id);
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout);
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id);
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id);
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id);
+
+/*  Memory pools  */
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size,
+    const osMemoryPoolAttr_t *attr);
+const char* osMemoryPoolGetName(osMemoryPoolId_t mp_id);
+void* osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout);
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block);
+uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id);
+uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id);
+uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id);
+uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id);
+osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id);
+
+/*  Message queues  */
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size,
+    const osMessageQueueAttr_t *attr);
+const char* osMessageQueueGetName(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr,
+    uint8_t msg_prio, uint32_t timeout);
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr,
+    uint8_t *msg_prio, uint32_t timeout);
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id);
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id);
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id);
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id);
+
+#endif /* _INC_CMSIS_OS2_H_ */
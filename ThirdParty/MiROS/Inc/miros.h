@@ -33,6 +33,188 @@
  * */
 #define MIROS_NUM_TASKS             32
 
+/**
+ * @brief Task stacks alignment (in bytes), stacks are aligned at run time
+ * by MiROS, or at compile time (miros.hpp)
+ * */
+#define MIROS_STACK_ALIGNMENT       8
+
+/**
+ * @brief Kernel exception priorities, set by #MIROS_Start(). PendSV (task
+ * switch) runs at the lowest priority, after all other interrupts. SVC
+ * (system calls, and the first task's launch) runs at the highest priority.
+ * */
+#ifndef MIROS_PENDSV_PRIORITY
+#define MIROS_PENDSV_PRIORITY       ((1UL << __NVIC_PRIO_BITS) - 1UL)
+#endif
+
+#ifndef MIROS_SYSTICK_PRIORITY
+#define MIROS_SYSTICK_PRIORITY      TICK_INT_PRIORITY
+#endif
+
+#ifndef MIROS_SVC_PRIORITY
+#define MIROS_SVC_PRIORITY          0
+#endif
+
+/**
+ * @brief Scheduling algorithms, selected by #MIROS_SCHEDULER
+ *
+ * MIROS_SCHED_ROUND_ROBIN: all tasks are executed in turns, in the order
+ *    they were added (round_robin.c)
+ * MIROS_SCHED_PRIORITY: preemptive fixed priority, tasks of the same
+ *    priority are executed in turns (priority.c)
+ * */
+#define MIROS_SCHED_ROUND_ROBIN     0
+#define MIROS_SCHED_PRIORITY        1
+
+/**
+ * @brief Scheduling algorithm used by MiROS
+ * */
+#ifndef MIROS_SCHEDULER
+#define MIROS_SCHEDULER             MIROS_SCHED_PRIORITY
+#endif
+
+/**
+ * @brief Number of task priority levels, priorities range from 0 (lowest)
+ * to `MIROS_NUM_PRIORITIES - 1` (highest)
+ * */
+#define MIROS_NUM_PRIORITIES        32
+
+/**
+ * @brief Priority of tasks initialized with #MIROS_TaskInitialize()
+ * */
+#define MIROS_DEFAULT_PRIORITY      0
+
+/**
+ * @brief Reject periodic tasks that would make the task set unschedulable,
+ * see #MIROS_TaskInitializeWithAttributes(). Requires the priority scheduler.
+ * */
+#ifndef MIROS_ADMISSION_CONTROL
+#define MIROS_ADMISSION_CONTROL     (MIROS_SCHEDULER == MIROS_SCHED_PRIORITY)
+#endif
+
+/**
+ * @brief Enforce periodic tasks' execution budgets (their WCET), measured
+ * in CPU cycles using DWT cycle counter. A task that exhausts its budget is
+ * suspended until its next period, see #MIROS_TaskOverrunCallback().
+ * */
+#ifndef MIROS_BUDGET_ENFORCEMENT
+#define MIROS_BUDGET_ENFORCEMENT    1
+#endif
+
+/**
+ * @brief Mixed criticality: a high criticality task that exhausts its low
+ * criticality budget switches the system to high criticality mode, where
+ * low criticality tasks are dropped until the next idle instant. Requires
+ * the priority scheduler and budget enforcement.
+ * */
+#ifndef MIROS_MIXED_CRITICALITY
+#define MIROS_MIXED_CRITICALITY     \
+  ((MIROS_SCHEDULER == MIROS_SCHED_PRIORITY) && MIROS_BUDGET_ENFORCEMENT)
+#endif
+
+/**
+ * @brief Criticality levels, of tasks and of the system mode
+ * */
+#define MIROS_CRITICALITY_LO        0
+#define MIROS_CRITICALITY_HI        1
+
+/**
+ * @brief Proportional share scheduling of one priority level
+ * (#MIROS_FAIR_PRIORITY), beneath the real-time priorities: its tasks are
+ * charged the CPU cycles they use (DWT cycle counter), scaled down by their
+ * weights, into their virtual runtimes, and the ready task with the lowest
+ * virtual runtime is selected. So each task gets CPU time in proportion to
+ * its weight. Requires the priority scheduler and budget enforcement.
+ * */
+#ifndef MIROS_FAIR_SHARE
+#define MIROS_FAIR_SHARE            \
+  ((MIROS_SCHEDULER == MIROS_SCHED_PRIORITY) && MIROS_BUDGET_ENFORCEMENT)
+#endif
+
+/**
+ * @brief Priority level of the proportional share tasks, just above
+ * #MIROS_DEFAULT_PRIORITY, so tasks initialized without attributes are still
+ * executed in turns
+ * */
+#define MIROS_FAIR_PRIORITY         1
+
+/**
+ * @brief Default task weight, a task of weight #MIROS_FAIR_WEIGHT is charged
+ * its used CPU cycles as is
+ * */
+#define MIROS_FAIR_WEIGHT           1024
+
+/**
+ * @brief Multilevel feedback queue (miros_mlfq.h), requires the priority
+ * scheduler
+ * */
+#ifndef MIROS_MLFQ_ENABLE
+#define MIROS_MLFQ_ENABLE           (MIROS_SCHEDULER == MIROS_SCHED_PRIORITY)
+#endif
+
+/**
+ * @brief Sporadic servers for aperiodic tasks (miros_server.h), requires
+ * the priority scheduler and budget enforcement
+ * */
+#ifndef MIROS_SERVER_ENABLE
+#define MIROS_SERVER_ENABLE         \
+  ((MIROS_SCHEDULER == MIROS_SCHED_PRIORITY) && MIROS_BUDGET_ENFORCEMENT)
+#endif
+
+/**
+ * @brief Time partitions (miros_partition.h), requires the priority
+ * scheduler
+ * */
+#ifndef MIROS_PARTITION_ENABLE
+#define MIROS_PARTITION_ENABLE      (MIROS_SCHEDULER == MIROS_SCHED_PRIORITY)
+#endif
+
+/**
+ * @brief Software timers (miros_timer.h), ticked by the kernel tick
+ * */
+#ifndef MIROS_TIMER_ENABLE
+#define MIROS_TIMER_ENABLE          1
+#endif
+
+/**
+ * @brief Record kernel events (task switch, block, unblock) into MiROS
+ * trace buffer (miros_trace.h)
+ * */
+#ifndef MIROS_TRACE_ENABLE
+#define MIROS_TRACE_ENABLE          1
+#endif
+
+/**
+ * @brief Place a function in RAM (`.RamFunc` section, copied to RAM by the
+ * startup code along with `.data`). Used for the code that must keep running
+ * while the flash is busy being programmed or erased (the kernel tick,
+ * context switch and flash ISR), as any instruction fetch from flash stalls
+ * the bus until the flash operation is complete.
+ * */
+#define MIROS_RAMFUNC               __attribute__((section(".RamFunc"), noinline))
+
+/**
+ * @brief Enter a critical section, by saving PRIMASK into @p primask then
+ * disabling interrupts. Critical sections can be nested, as long as each
+ * level uses its own @p primask variable.
+ *
+ * @note Requires CMSIS core header to be included before miros.h
+ * */
+#define MIROS_CRITICAL_ENTER(primask)   \
+  do {  \
+    (primask) = __get_PRIMASK();  \
+    __disable_irq();  \
+  } while (0)
+
+/**
+ * @brief Exit a critical section, by restoring PRIMASK from @p primask
+ * */
+#define MIROS_CRITICAL_EXIT(primask)    \
+  do {  \
+    __set_PRIMASK(primask);  \
+  } while (0)
+
 /**
  * @brief Task handle (function) typedef. The task handle is the address
  * of a normal C function, that is called when the task is ready to be executed.
@@ -40,6 +222,22 @@
  * */
 typedef void (*TaskHandle_t)(void);
 
+/**
+ * @brief Task states
+ *
+ * MIROS_TASK_READY: task can be selected by the scheduler to run.
+ * MIROS_TASK_BLOCKED: task is waiting for an event (a semaphore, the
+ *    completion of an I/O operation, ...), and will not be scheduled until
+ *    it's unblocked by #MIROS_TaskUnblock().
+ * MIROS_TASK_SUSPENDED: periodic task exhausted its execution budget, and
+ *    will not be scheduled until its next period.
+ * */
+typedef enum {
+  MIROS_TASK_READY = 0,
+  MIROS_TASK_BLOCKED,
+  MIROS_TASK_SUSPENDED,
+} TaskState_t;
+
 /**
  * @brief Task structure, that holds task's information
  *
@@ -58,6 +256,46 @@ typedef void (*TaskHandle_t)(void);
  * TaskHandle_t handle: The task's handle, or function that will be called
  *    to run when the task is ready. It must be in the form of an infinite loop
  *    and never return.
+ * TaskState_t state: Task's current state, managed by MiROS.
+ * Task_t * next: link to the next task, in the wait queue of the object
+ *    the task is blocked on (if any). Managed by MiROS.
+ * uint32_t timeout: number of ticks remaining until the task is unblocked,
+ *    0 if the task is not delayed. Managed by MiROS.
+ * uint32_t id: task's index, in the order the tasks were added (the idle
+ *    task's id is #MIROS_NUM_TASKS). Managed by MiROS.
+ * uint32_t priority: task's priority, used by the priority scheduler.
+ *    Set from the task's attributes, see #TaskAttributes_t.
+ * uint32_t threshold: task's preemption threshold, used by the priority
+ *    scheduler. Set from the task's attributes, see #TaskAttributes_t.
+ * uint32_t period: task's period in OS ticks, 0 if the task isn't periodic.
+ *    Set from the task's attributes, see #TaskAttributes_t.
+ * uint32_t wcet: task's worst case execution time per period, in
+ *    microseconds. Set from the task's attributes, see #TaskAttributes_t.
+ * uint32_t release: number of ticks until the task's next period starts.
+ *    Managed by MiROS.
+ * uint32_t budget: CPU cycles left from the task's budget in the current
+ *    period. Managed by MiROS.
+ * uint32_t overruns: number of periods in which the task exhausted its
+ *    budget. Managed by MiROS.
+ * struct Server * server: sporadic server the task is attached to, NULL if
+ *    none. Set by #MIROS_ServerAttach().
+ * uint32_t criticality: task's criticality level. Set from the task's
+ *    attributes, see #TaskAttributes_t.
+ * uint32_t wcet_hi: task's high criticality WCET, in microseconds. Set from
+ *    the task's attributes, see #TaskAttributes_t.
+ * uint32_t weight: task's proportional share weight. Set from the task's
+ *    attributes, see #TaskAttributes_t.
+ * uint32_t vruntime: task's virtual runtime, CPU cycles used by the task
+ *    scaled by `MIROS_FAIR_WEIGHT / weight`. Managed by MiROS.
+ * uint32_t control: CONTROL register value loaded when the task is switched
+ *    in (nPRIV bit set for unprivileged tasks). Set from the task's
+ *    attributes, see #TaskAttributes_t.
+ *
+ * > Tasks run on PSP, `stack_ptr` is the task's saved PSP while it's
+ * > switched out. An interrupt taken while the task runs stacks its
+ * > exception frame (8 words, 9 if realigned) on the task's stack, the
+ * > handlers themselves run on MSP (the startup stack, `_Min_Stack_Size`),
+ * > so task stacks don't need room for nested interrupts.
  *
  * > MiROS keeps added tasks in a FIFO task queue, that means
  * > tasks that are added first, are scheduled first.
@@ -66,13 +304,73 @@ typedef void (*TaskHandle_t)(void);
  * > means MiROS requires the tasks' structures to be allocated either
  * > statically, or dynamically, but never locally.
  * */
-typedef struct {
+typedef struct Task {
   uint32_t *stack;
   uint32_t stack_size;
   uint32_t stack_ptr;
   TaskHandle_t handle;
+  TaskState_t state;
+  struct Task *next;
+  uint32_t timeout;
+  uint32_t id;
+  uint32_t priority;
+  uint32_t threshold;
+  uint32_t period;
+  uint32_t wcet;
+  uint32_t release;
+  uint32_t budget;
+  uint32_t overruns;
+  struct Server *server;
+  uint32_t criticality;
+  uint32_t wcet_hi;
+  uint32_t weight;
+  uint32_t vruntime;
+  uint32_t control;
 } Task_t;
 
+/**
+ * @brief Optional task attributes, passed to
+ * #MIROS_TaskInitializeWithAttributes()
+ *
+ * uint32_t priority: task's priority, from 0 (lowest) to
+ *    `MIROS_NUM_PRIORITIES - 1` (highest). Ignored by the round robin
+ *    scheduler.
+ * uint32_t threshold: task's preemption threshold. Once the task starts
+ *    running, only tasks whose priority is above the threshold can preempt
+ *    it, until it blocks. Tasks whose priorities are within each others'
+ *    thresholds run cooperatively among themselves, while still being
+ *    preempted by more urgent tasks. A threshold lower than the priority
+ *    (like 0) is the same as the priority (fully preemptive). Ignored by
+ *    the round robin scheduler.
+ * uint32_t period: task's period (and relative deadline) in OS ticks, or 0
+ *    for a task that isn't periodic
+ * uint32_t wcet: task's worst case execution time per period, in
+ *    microseconds. Required for periodic tasks. For high criticality tasks,
+ *    it's the (optimistic) low criticality WCET.
+ * uint32_t criticality: task's criticality level, #MIROS_CRITICALITY_LO or
+ *    #MIROS_CRITICALITY_HI
+ * uint32_t wcet_hi: high criticality task's (pessimistic) WCET, in
+ *    microseconds, its budget in high criticality mode. 0 if it's the same
+ *    as `wcet`.
+ * uint32_t weight: task's share of the CPU time relative to the other tasks
+ *    of priority #MIROS_FAIR_PRIORITY, 0 for the default
+ *    (#MIROS_FAIR_WEIGHT)
+ * uint32_t unprivileged: 1 to run the task in unprivileged mode, where it
+ *    can't access the system control space (SysTick, NVIC, SCB, ...) nor
+ *    mask interrupts, and calls the kernel through system calls
+ *    (miros_syscall.h). 0 to run the task in privileged mode.
+ * */
+typedef struct {
+  uint32_t priority;
+  uint32_t threshold;
+  uint32_t period;
+  uint32_t wcet;
+  uint32_t criticality;
+  uint32_t wcet_hi;
+  uint32_t weight;
+  uint32_t unprivileged;
+} TaskAttributes_t;
+
 /**
  * @brief Initialize MiROS. Clears MiROS task queue and Initializes its
  * internal variables. Must be called before adding any tasks, and before
@@ -109,12 +407,78 @@ void MIROS_Initialize(TaskHandle_t idle_handle, uint32_t *idle_stack,
 void MIROS_TaskInitialize(Task_t *task, TaskHandle_t handle, uint32_t *stack,
     uint32_t stack_size);
 
+/**
+ * @brief Same as #MIROS_TaskInitialize(), with the task's attributes
+ * (priority, ...) given by @p attributes
+ *
+ * With #MIROS_ADMISSION_CONTROL, a periodic task is only added if the
+ * periodic task set stays schedulable: either the priorities are rate
+ * monotonic and the total utilization is within Liu & Layland bound
+ * `n * (2^(1/n) - 1)`, or every periodic task's worst case response time
+ * (exact response time analysis, using the tasks' actual priorities) is
+ * within its period. Tasks that aren't periodic are not accounted for, and
+ * must have lower priorities than the periodic tasks. Blocking on mutexes
+ * and preemption thresholds are not accounted for either.
+ *
+ * With #MIROS_MIXED_CRITICALITY, the test is done for both modes: all tasks
+ * with their low criticality WCETs, and high criticality tasks alone with
+ * their high criticality WCETs.
+ *
+ * @param [in] task pointer to the task structure to be initialized
+ * @param [in] handle address to the task's function
+ * @param [in] stack pointer to the stack's allocated stack memory
+ * @param [in] stack_size size of the allocated task's stack memory
+ * @param [in] attributes pointer to the task's attributes, or NULL to use
+ *    the defaults (#MIROS_DEFAULT_PRIORITY)
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the task was added, HAL_ERROR if it
+ *    was rejected by the admission control, or if #MIROS_NUM_TASKS tasks
+ *    were already added
+ * */
+HAL_StatusTypeDef MIROS_TaskInitializeWithAttributes(Task_t *task,
+    TaskHandle_t handle, uint32_t *stack, uint32_t stack_size,
+    const TaskAttributes_t *attributes);
+
+/**
+ * @brief Start MiROS: resets MSP to the top of RAM (`_estack`), discarding
+ * the startup stack (`main()`'s frames), sets the kernel's exception
+ * priorities, converts tasks' and servers' budgets to CPU cycles at the
+ * current `SystemCoreClock`, and launches the highest priority ready task
+ * (or idle task) through `SVC`. Doesn't return.
+ *
+ * Tasks run on PSP, and the startup stack becomes the dedicated stack of
+ * the exception handlers (MSP), shared by all nested interrupts.
+ *
+ * Until it's called, #MIROS_Sched() doesn't switch tasks, so SysTick and
+ * interrupts can be enabled (HAL_Init, ...) before the first task runs.
+ *
+ * @pre #MIROS_Initialize() was called
+ * @pre The system clock is configured (`SystemClock_Config()`)
+ * @pre Called from `main()`, in privileged thread mode
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_Start(void) __attribute__((noreturn));
+
+/**
+ * @brief Switch to the first task, called by the SVC handler for
+ * #MIROS_Start(). Doesn't return, and does nothing once the first task is
+ * running.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_Launch(void);
+
 /**
  * @param Start MiROS RTOS scheduler, which selects the next ready task
  * to be executed.
  *
- * @pre #MIROS_Initialize() was called
- * @pre At least 1 task was added
+ * @pre #MIROS_Start() was called, does nothing before the first task is
+ *    launched
  *
  * @post A task is selected, and is switched in to be executed
  *    for 1 OS tick duration
@@ -125,4 +489,108 @@ void MIROS_TaskInitialize(Task_t *task, TaskHandle_t handle, uint32_t *stack,
  * */
 void MIROS_Sched(void);
 
+/**
+ * @brief Get the number of task switches since MiROS was initialized, used
+ * to measure the effect of scheduling choices (priorities, thresholds, ...)
+ *
+ * @param void
+ *
+ * @return uint32_t: number of task switches
+ * */
+uint32_t MIROS_GetSwitchCount(void);
+
+/**
+ * @brief Get the currently running task
+ *
+ * @param void
+ *
+ * @return Task_t *: pointer to the running task, or NULL if the scheduler
+ *    did not switch to any task yet
+ * */
+Task_t* MIROS_GetRunningTask(void);
+
+/**
+ * @brief Block the running task, and switch to the next ready task.
+ *
+ * The switch happens as soon as interrupts are enabled, so the caller can
+ * call it from within a critical section (after adding the running task to
+ * the wait queue of a kernel object), and the task is switched out when the
+ * critical section is exited.
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @post Running task is not scheduled until #MIROS_TaskUnblock() is called
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_TaskBlock(void);
+
+/**
+ * @brief Mark a blocked task as ready, so it can be scheduled again.
+ *
+ * Can be called from both task and interrupt contexts.
+ *
+ * @param [in] task pointer to the blocked task
+ *
+ * @return void
+ * */
+void MIROS_TaskUnblock(Task_t *task);
+
+/**
+ * @brief Block the running task for @p ticks OS ticks
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] ticks number of OS ticks to block the task for, the task
+ *    isn't blocked if it's 0
+ *
+ * @return void
+ * */
+void MIROS_TaskDelay(uint32_t ticks);
+
+/**
+ * @brief Block the running periodic task until its next period starts
+ *
+ * @pre Called from a periodic task's context
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_TaskWaitPeriod(void);
+
+/**
+ * @brief Called when a periodic task exhausts its execution budget, before
+ * the task is suspended until its next period. Called from the scheduler
+ * with interrupts disabled. Weak, can be overridden by the application (to
+ * log the fault, reset the task's state, ...), `task->overruns` counts the
+ * overruns.
+ *
+ * @param [in] task pointer to the task that exhausted its budget
+ *
+ * @return void
+ * */
+void MIROS_TaskOverrunCallback(Task_t *task);
+
+/**
+ * @brief Get the system's criticality mode
+ *
+ * @param void
+ *
+ * @return uint32_t: #MIROS_CRITICALITY_LO or #MIROS_CRITICALITY_HI
+ * */
+uint32_t MIROS_GetCriticality(void);
+
+/**
+ * @brief MiROS tick, updates delayed tasks then calls the scheduler. Called
+ * from SysTick interrupt (HAL_SYSTICK_Callback()).
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_Tick(void);
+
 #endif /* MIROS_H_ */
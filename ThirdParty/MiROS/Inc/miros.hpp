@@ -0,0 +1,398 @@
+/******************************************************************************
+ * @file    miros.hpp
+ * @brief   MiROS C++17 wrappers, statically sized tasks and kernel objects
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_HPP_
+#define _INC_MIROS_HPP_
+
+/**
+ * Header-only C++17 layer over MiROS C API. Objects hold their storage
+ * (task stacks, queue slots, pool blocks), sized and aligned at compile
+ * time, and are constant-initialized: a statically allocated object is
+ * placed in .bss (or .data) with no constructor running at startup. Every
+ * member function is an inline call of the matching C function.
+ *
+ * static miros::Task<128, 3> Worker;
+ * static miros::Mutex<3> Lock;
+ * static miros::Queue<Sample_t, 8> Samples;
+ *
+ * Worker.start(worker);
+ * {
+ *   miros::LockGuard<miros::Mutex<3>> guard(Lock);
+ *   ...
+ * }
+ * */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+#include "miros_mutex.h"
+#endif
+}
+
+namespace miros {
+
+/**
+ * @brief Critical section, interrupts are disabled for the object's
+ * lifetime (and restored to their previous state)
+ * */
+class CriticalSection {
+ public:
+  CriticalSection() noexcept {
+    MIROS_CRITICAL_ENTER(primask_);
+  }
+
+  ~CriticalSection() {
+    MIROS_CRITICAL_EXIT(primask_);
+  }
+
+  CriticalSection(const CriticalSection&) = delete;
+  CriticalSection& operator=(const CriticalSection&) = delete;
+
+ private:
+  std::uint32_t primask_;
+};
+
+/**
+ * @brief Task with a stack of @p StackWords words, and priority
+ * @p Priority
+ *
+ * The stack is aligned, and its size is a multiple of
+ * #MIROS_STACK_ALIGNMENT, at compile time, so MiROS stack alignment leaves
+ * it unchanged.
+ * */
+template <std::size_t StackWords, std::uint32_t Priority = MIROS_DEFAULT_PRIORITY>
+class Task {
+  static_assert(Priority < MIROS_NUM_PRIORITIES,
+      "task priority out of range");
+  static_assert(StackWords >= 32, "task stack is too small");
+  static_assert(((StackWords * sizeof(std::uint32_t)) % MIROS_STACK_ALIGNMENT)
+      == 0, "task stack size must be a multiple of the stack alignment");
+
+ public:
+  constexpr Task() noexcept = default;
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  /**
+   * @brief Add the task to MiROS, see #MIROS_TaskInitializeWithAttributes()
+   *
+   * @param [in] handle task's function
+   * @param [in] attributes task's attributes, its priority is overridden by
+   *    @p Priority
+   *
+   * @return HAL_StatusTypeDef: HAL_OK, or HAL_ERROR if rejected by the
+   *    admission control
+   * */
+  HAL_StatusTypeDef start(TaskHandle_t handle,
+      TaskAttributes_t attributes = TaskAttributes_t()) noexcept {
+    attributes.priority = Priority;
+    return MIROS_TaskInitializeWithAttributes(&task_, handle, stack_,
+        StackWords, &attributes);
+  }
+
+  Task_t* native() noexcept {
+    return &task_;
+  }
+
+  static constexpr std::size_t stack_words = StackWords;
+  static constexpr std::uint32_t priority = Priority;
+
+ private:
+  Task_t task_ { };
+  alignas(MIROS_STACK_ALIGNMENT) std::uint32_t stack_[StackWords] { };
+};
+
+/**
+ * @brief Counting semaphore
+ * */
+class Semaphore {
+ public:
+  explicit constexpr Semaphore(std::uint32_t count = 0) noexcept
+      : sem_ { count, nullptr, nullptr } {
+  }
+
+  Semaphore(const Semaphore&) = delete;
+  Semaphore& operator=(const Semaphore&) = delete;
+
+  void wait() noexcept {
+    MIROS_SemWait(&sem_);
+  }
+
+  bool tryWait() noexcept {
+    return MIROS_SemTryWait(&sem_) != 0;
+  }
+
+  void post() noexcept {
+    MIROS_SemPost(&sem_);
+  }
+
+  std::uint32_t count() const noexcept {
+    return sem_.count;
+  }
+
+  Semaphore_t* native() noexcept {
+    return &sem_;
+  }
+
+ private:
+  Semaphore_t sem_;
+};
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+/**
+ * @brief SRP mutex with ceiling @p Ceiling, see miros_mutex.h
+ * */
+template <std::uint32_t Ceiling>
+class Mutex {
+  static_assert(Ceiling != MIROS_MUTEX_IRQ_CEILING(0),
+      "BASEPRI can't mask priority 0 interrupts");
+  static_assert(Ceiling < MIROS_MUTEX_IRQ_CEILING(1UL << __NVIC_PRIO_BITS),
+      "mutex ceiling out of range");
+
+ public:
+  constexpr Mutex() noexcept
+      : mutex_ { Ceiling, nullptr, 0, nullptr, 0, nullptr } {
+  }
+
+  Mutex(const Mutex&) = delete;
+  Mutex& operator=(const Mutex&) = delete;
+
+  void lock() noexcept {
+    MIROS_MutexLock(&mutex_);
+  }
+
+  void unlock() noexcept {
+    MIROS_MutexUnlock(&mutex_);
+  }
+
+  Mutex_t* native() noexcept {
+    return &mutex_;
+  }
+
+  static constexpr std::uint32_t ceiling = Ceiling;
+
+ private:
+  Mutex_t mutex_;
+};
+#endif
+
+/**
+ * @brief Lock a mutex (any type with lock() and unlock()) for the guard's
+ * lifetime
+ * */
+template <typename M>
+class LockGuard {
+ public:
+  explicit LockGuard(M &mutex) noexcept
+      : mutex_(mutex) {
+    mutex_.lock();
+  }
+
+  ~LockGuard() {
+    mutex_.unlock();
+  }
+
+  LockGuard(const LockGuard&) = delete;
+  LockGuard& operator=(const LockGuard&) = delete;
+
+ private:
+  M &mutex_;
+};
+
+/**
+ * @brief FIFO queue of @p N items of type @p T, copied in and out. Senders
+ * block while the queue is full, receivers block while it's empty.
+ * */
+template <typename T, std::size_t N>
+class Queue {
+  static_assert(N > 0, "queue can't be empty");
+  static_assert(std::is_trivially_copyable<T>::value,
+      "queue items are copied, they must be trivially copyable");
+
+ public:
+  constexpr Queue() noexcept
+      : slots_(N), items_(0) {
+  }
+
+  Queue(const Queue&) = delete;
+  Queue& operator=(const Queue&) = delete;
+
+  void push(const T &item) noexcept {
+    slots_.wait();
+    put(item);
+  }
+
+  bool tryPush(const T &item) noexcept {
+    if (!slots_.tryWait()) {
+      return false;
+    }
+    put(item);
+    return true;
+  }
+
+  T pop() noexcept {
+    items_.wait();
+    return get();
+  }
+
+  bool tryPop(T &item) noexcept {
+    if (!items_.tryWait()) {
+      return false;
+    }
+    item = get();
+    return true;
+  }
+
+  std::size_t size() const noexcept {
+    return items_.count();
+  }
+
+  static constexpr std::size_t capacity = N;
+
+ private:
+  void put(const T &item) noexcept {
+    CriticalSection critical;
+    buffer_[tail_] = item;
+    tail_ = (tail_ + 1 == N) ? 0 : tail_ + 1;
+    items_.post();
+  }
+
+  T get() noexcept {
+    T item;
+    {
+      CriticalSection critical;
+      item = buffer_[head_];
+      head_ = (head_ + 1 == N) ? 0 : head_ + 1;
+    }
+    slots_.post();
+    return item;
+  }
+
+  Semaphore slots_;
+  Semaphore items_;
+  std::size_t head_ = 0;
+  std::size_t tail_ = 0;
+  T buffer_[N] { };
+};
+
+/**
+ * @brief Pool of @p N objects of type @p T. Blocks are handed out from the
+ * pool's storage the first time, then from a free list, so the pool needs
+ * no initialization.
+ * */
+template <typename T, std::size_t N>
+class Pool {
+  static_assert(N > 0, "pool can't be empty");
+
+ public:
+  constexpr Pool() noexcept
+      : available_(N) {
+  }
+
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+
+  /**
+   * @brief Construct an object in a free block, blocks until a block is free
+   * */
+  template <typename ... Args>
+  T* create(Args&&... args) {
+    available_.wait();
+    return new (take()) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Construct an object in a free block, nullptr if none is free
+   * */
+  template <typename ... Args>
+  T* tryCreate(Args&&... args) {
+    if (!available_.tryWait()) {
+      return nullptr;
+    }
+    return new (take()) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Destroy an object created by the pool, and free its block
+   * */
+  void destroy(T *object) noexcept {
+    Block *block = reinterpret_cast<Block*>(object);
+
+    object->~T();
+    {
+      CriticalSection critical;
+      block->next = free_;
+      free_ = block;
+    }
+    available_.post();
+  }
+
+  std::size_t space() const noexcept {
+    return available_.count();
+  }
+
+  static constexpr std::size_t capacity = N;
+
+ private:
+  union Block {
+    Block *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  /* a block is reserved (available_ was taken), one of the two is free */
+  void* take() noexcept {
+    CriticalSection critical;
+    Block *block;
+
+    if (free_ != nullptr) {
+      block = free_;
+      free_ = block->next;
+    } else {
+      block = &blocks_[used_++];
+    }
+
+    return block->storage;
+  }
+
+  Semaphore available_;
+  Block *free_ = nullptr;
+  std::size_t used_ = 0;
+  Block blocks_[N] { };
+};
+
+} /* namespace miros */
+
+#endif /* _INC_MIROS_HPP_ */
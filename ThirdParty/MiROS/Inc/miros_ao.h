@@ -0,0 +1,202 @@
+/******************************************************************************
+ * @file    miros_ao.h
+ * @brief   Active objects, event-driven tasks with their own event queues
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_AO_H_
+#define _INC_MIROS_AO_H_
+
+/**
+ * An active object owns its data and an event queue, and only talks to
+ * other active objects through events, so no data is shared and nothing
+ * needs locking. Its dispatch function handles one event at a time, run to
+ * completion, and must not block.
+ *
+ * An active object is normally mapped onto a MiROS task, whose function
+ * calls #MIROS_AoRun():
+ *
+ * static ActiveObject_t Blinky;
+ * static Event_t *BlinkyQueue[8];
+ *
+ * void blinky_task(void) {
+ *   MIROS_AoRun(&Blinky);
+ * }
+ *
+ * (void) MIROS_AoInitialize(&Blinky, 1, blinky_dispatch, BlinkyQueue, 8);
+ *
+ * Active objects without a task of their own (stackless) are started with
+ * #MIROS_AoStartStackless(), and all run by one task that calls
+ * #MIROS_AoRunStackless(). Events posted to them also post a shared ready
+ * semaphore, so the task sleeps until one of them has an event, and then
+ * dispatches it, higher ids first.
+ *
+ * Events are sent to one active object by #MIROS_AoPost(), or multicast to
+ * all the subscribers of the event's signal by #MIROS_AoPublish(). Active
+ * objects are bus subscribers (miros_bus.h): their ids are bus subscriber
+ * ids (less than #MIROS_BUS_SUBSCRIBERS), their signals are bus topics, and
+ * publishing is the bus's, so tasks and active objects subscribe to the
+ * same topics.
+ *
+ * > Requires miros.h, miros_sem.h, miros_event.h and miros_bus.h to be
+ * > included first
+ * */
+
+struct ActiveObject;
+
+/**
+ * @brief Active object's dispatch function, handles one event
+ *
+ * @param [in] me pointer to the active object
+ * @param [in] event pointer to the event, #MIROS_SIGNAL_INIT when the
+ *    active object starts
+ * */
+typedef void (*AoDispatch_t)(struct ActiveObject *me, const Event_t *event);
+
+/**
+ * @brief Active object, applications extend it with their own data (as the
+ * first member of their own structure)
+ *
+ * BusSubscriber_t subscriber: active object's event queue and id, on the
+ *    bus (first member, the bus subscriber is the active object)
+ * AoDispatch_t dispatch: event dispatch function
+ * */
+typedef struct ActiveObject {
+  BusSubscriber_t subscriber;
+  AoDispatch_t dispatch;
+} ActiveObject_t;
+
+/**
+ * @brief Initialize an active object, and register its id on the bus
+ *
+ * @param [in] ao pointer to the active object
+ * @param [in] id active object's id, a bus subscriber id, less than
+ *    #MIROS_BUS_SUBSCRIBERS and unique
+ * @param [in] dispatch event dispatch function
+ * @param [in] buffer pointer to the event queue's storage
+ * @param [in] length event queue's length
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the active object was initialized,
+ *    HAL_ERROR if @p id is invalid, or already used
+ * */
+HAL_StatusTypeDef MIROS_AoInitialize(ActiveObject_t *ao, uint32_t id,
+    AoDispatch_t dispatch, Event_t **buffer, uint32_t length);
+
+/**
+ * @brief Dispatch the #MIROS_SIGNAL_INIT event to the active object, in the
+ * calling task's context
+ *
+ * @param [in] ao pointer to the active object
+ *
+ * @return void
+ * */
+void MIROS_AoStart(ActiveObject_t *ao);
+
+/**
+ * @brief Start the active object, then dispatch its events forever. Called
+ * by the active object's task.
+ *
+ * @param [in] ao pointer to the active object
+ *
+ * @return void
+ * */
+void MIROS_AoRun(ActiveObject_t *ao) __attribute__((noreturn));
+
+/**
+ * @brief Start a stackless active object (dispatches #MIROS_SIGNAL_INIT, in
+ * the calling task's context), and have its events run by
+ * #MIROS_AoRunStackless()
+ *
+ * @param [in] ao pointer to the active object
+ *
+ * @return void
+ * */
+void MIROS_AoStartStackless(ActiveObject_t *ao);
+
+/**
+ * @brief Dispatch stackless active objects' events forever, one at a time,
+ * from the highest id active object that has one. Blocks the calling task
+ * while they have no events.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_AoRunStackless(void) __attribute__((noreturn));
+
+/**
+ * @brief Dispatch the active object's oldest event, if any, without
+ * blocking. Used to poll an active object from a task that does other work.
+ *
+ * @param [in] ao pointer to the active object
+ *
+ * @return uint32_t: 1 if an event was dispatched, 0 if the queue was empty
+ * */
+uint32_t MIROS_AoRunOnce(ActiveObject_t *ao);
+
+/**
+ * @brief Post @p event to the active object. Doesn't block, can be called
+ * from ISRs.
+ *
+ * @param [in] ao pointer to the active object
+ * @param [in] event pointer to the event
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the event was posted, HAL_ERROR if
+ *    the active object's queue is full
+ * */
+HAL_StatusTypeDef MIROS_AoPost(ActiveObject_t *ao, Event_t *event);
+
+/**
+ * @brief Subscribe the active object to @p signal
+ *
+ * @param [in] ao pointer to the active object
+ * @param [in] signal signal, less than #MIROS_BUS_TOPICS
+ *
+ * @return void
+ * */
+void MIROS_AoSubscribe(ActiveObject_t *ao, uint16_t signal);
+
+/**
+ * @brief Unsubscribe the active object from @p signal
+ *
+ * @param [in] ao pointer to the active object
+ * @param [in] signal signal, less than #MIROS_BUS_TOPICS
+ *
+ * @return void
+ * */
+void MIROS_AoUnsubscribe(ActiveObject_t *ao, uint16_t signal);
+
+/**
+ * @brief Post @p event to all the subscribers of its signal, active objects
+ * and tasks, through #MIROS_BusPublish(). The publisher gives up its
+ * reference to the event, which is garbage collected if there are no
+ * subscribers. Doesn't block, can be called from ISRs.
+ *
+ * @param [in] event pointer to the event
+ *
+ * @return uint32_t: number of subscribers the event was posted to
+ * */
+uint32_t MIROS_AoPublish(Event_t *event);
+
+#endif /* _INC_MIROS_AO_H_ */
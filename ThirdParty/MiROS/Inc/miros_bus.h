@@ -0,0 +1,169 @@
+/******************************************************************************
+ * @file    miros_bus.h
+ * @brief   Publish-subscribe event bus, with static topic tables
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_BUS_H_
+#define _INC_MIROS_BUS_H_
+
+/**
+ * Tasks subscribe to topics, and receive every event published on them.
+ * Topics are numbered at compile time (0 to #MIROS_BUS_TOPICS - 1, an
+ * event's topic is its signal), and each topic's subscribers are a bitmap
+ * of subscriber ids in a static table. The bus is the only subscriber
+ * registry: active objects (miros_ao.h) are bus subscribers, and publish
+ * through it.
+ *
+ * Publishing an event posts a reference to it to all the topic's
+ * subscribers, without copying it: a sensor sample taken from an event
+ * pool (#MIROS_EventNew()) is shared by all its receivers, and returned to
+ * its pool once the last receiver releases it (#MIROS_EventGc()). The
+ * publisher holds an extra reference while posting, so a subscriber that
+ * runs, and releases the event, before the others are posted to doesn't
+ * free it. Each post is its own short critical section, and subscribers
+ * receive the event in decreasing id order.
+ *
+ * void logger_task(void) {
+ *   MIROS_BusSubscribe(&Logger, SAMPLE_TOPIC);
+ *   for (;;) {
+ *     Event_t *event = MIROS_BusReceive(&Logger);
+ *     log_sample((const SampleEvent_t*) event);
+ *     MIROS_EventGc(event);
+ *   }
+ * }
+ *
+ * > Requires miros.h, miros_sem.h and miros_event.h to be included first
+ * */
+
+/**
+ * @brief Number of topics
+ * */
+#ifndef MIROS_BUS_TOPICS
+#define MIROS_BUS_TOPICS            32
+#endif
+
+/**
+ * @brief Maximum number of subscribers, ids are 0 to
+ * MIROS_BUS_SUBSCRIBERS - 1 (32 at most, ids are bits of the topic
+ * bitmaps)
+ * */
+#ifndef MIROS_BUS_SUBSCRIBERS
+#define MIROS_BUS_SUBSCRIBERS       8
+#endif
+
+/**
+ * @brief Bus subscriber
+ *
+ * EventQueue_t queue: subscriber's event queue
+ * uint32_t id: subscriber's id, unique
+ * uint32_t dropped: number of events dropped because the queue was full
+ * */
+typedef struct {
+  EventQueue_t queue;
+  uint32_t id;
+  uint32_t dropped;
+} BusSubscriber_t;
+
+/**
+ * @brief Initialize a subscriber, and register its id
+ *
+ * @param [in] subscriber pointer to the subscriber
+ * @param [in] id subscriber's id, less than #MIROS_BUS_SUBSCRIBERS and
+ *    unique
+ * @param [in] buffer pointer to the event queue's storage
+ * @param [in] length event queue's length
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the subscriber was initialized,
+ *    HAL_ERROR if @p id is invalid, or already used
+ * */
+HAL_StatusTypeDef MIROS_BusSubscriberInitialize(BusSubscriber_t *subscriber,
+    uint32_t id, Event_t **buffer, uint32_t length);
+
+/**
+ * @brief Get the subscriber registered with @p id
+ *
+ * @param [in] id subscriber's id, less than #MIROS_BUS_SUBSCRIBERS
+ *
+ * @return BusSubscriber_t *: pointer to the subscriber, or NULL if none is
+ *    registered with @p id
+ * */
+BusSubscriber_t* MIROS_BusGetSubscriber(uint32_t id);
+
+/**
+ * @brief Subscribe to @p topic
+ *
+ * @param [in] subscriber pointer to the subscriber
+ * @param [in] topic topic, less than #MIROS_BUS_TOPICS
+ *
+ * @return void
+ * */
+void MIROS_BusSubscribe(BusSubscriber_t *subscriber, uint16_t topic);
+
+/**
+ * @brief Unsubscribe from @p topic
+ *
+ * @param [in] subscriber pointer to the subscriber
+ * @param [in] topic topic, less than #MIROS_BUS_TOPICS
+ *
+ * @return void
+ * */
+void MIROS_BusUnsubscribe(BusSubscriber_t *subscriber, uint16_t topic);
+
+/**
+ * @brief Publish @p event on its topic (its signal). The publisher gives
+ * up its reference to the event, which is garbage collected if it wasn't
+ * delivered. Doesn't block, can be called from ISRs.
+ *
+ * The event is posted to all subscribers in one critical section, so they
+ * are all ready before any of them preempts the publisher.
+ *
+ * @param [in] event pointer to the event
+ *
+ * @return uint32_t: number of subscribers the event was delivered to
+ * */
+uint32_t MIROS_BusPublish(Event_t *event);
+
+/**
+ * @brief Get the oldest event delivered to the subscriber, blocks the
+ * running task until an event is available. The subscriber calls
+ * #MIROS_EventGc() once it's done with the event.
+ *
+ * @param [in] subscriber pointer to the subscriber
+ *
+ * @return Event_t *: pointer to the event
+ * */
+Event_t* MIROS_BusReceive(BusSubscriber_t *subscriber);
+
+/**
+ * @brief Get the oldest event delivered to the subscriber, if any, without
+ * blocking
+ *
+ * @param [in] subscriber pointer to the subscriber
+ *
+ * @return Event_t *: pointer to the event, or NULL if there's none
+ * */
+Event_t* MIROS_BusTryReceive(BusSubscriber_t *subscriber);
+
+#endif /* _INC_MIROS_BUS_H_ */
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * @file    miros_capture.h
+ * @brief   MiROS timer input capture measurement service (frequency, period, duty)
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_CAPTURE_H_
+#define _INC_MIROS_CAPTURE_H_
+
+/**
+ * @brief Capture task's update period, in OS ticks
+ * */
+#ifndef MIROS_CAPTURE_UPDATE_PERIOD
+#define MIROS_CAPTURE_UPDATE_PERIOD 10
+#endif
+
+/**
+ * @brief Number of updates without any captured edge, after which the
+ * signal is considered stopped, and its measurements are cleared
+ * */
+#ifndef MIROS_CAPTURE_TIMEOUT
+#define MIROS_CAPTURE_TIMEOUT       10
+#endif
+
+/**
+ * @brief Capture measurements
+ *
+ * uint32_t frequency: signal's frequency in mHz
+ * uint32_t period: signal's period in ns
+ * uint32_t pulse: signal's high pulse width in ns (0 if not measured)
+ * uint32_t duty: signal's duty cycle in 0.01 % units (0 if not measured)
+ * uint32_t edges: number of periods averaged in the last update
+ * */
+typedef struct {
+  uint32_t frequency;
+  uint32_t period;
+  uint32_t pulse;
+  uint32_t duty;
+  uint32_t edges;
+} CaptureResult_t;
+
+/**
+ * @brief Capture channel structure
+ *
+ * The timer is configured by the application in PWM input mode (slave reset
+ * mode on the rising edge of TI1 or TI2), so the period channel captures the
+ * signal's period, and the pulse channel captures its high pulse width,
+ * directly. Both channels are linked to circular, half-word DMA channels, so
+ * the captures are transferred into the buffers without any CPU involvement.
+ *
+ * The channel is also an I/O device: MIROS_IO_READ requests, with a
+ * CaptureResult_t buffer and a length of 1, complete with the measurements of
+ * the next update, see #MIROS_CaptureRead().
+ *
+ * All members are managed by MiROS, except for the results, which are read
+ * by #MIROS_CaptureGet().
+ * */
+typedef struct Capture {
+  IoDevice_t device;
+  TIM_HandleTypeDef *htim;
+  uint32_t period_channel;
+  uint32_t pulse_channel;
+  uint32_t clock;
+  uint16_t *periods;
+  uint16_t *pulses;
+  uint32_t size;
+  uint32_t period_index;
+  uint32_t pulse_index;
+  uint32_t idle_updates;
+  CaptureResult_t result;
+  struct Capture *next;
+} Capture_t;
+
+/**
+ * @brief Initialize a capture channel, start the DMA captures and add the
+ * channel to the capture task's list.
+ *
+ * The buffers must be large enough to hold the edges captured in one update
+ * period: size > (maximum frequency * #MIROS_CAPTURE_UPDATE_PERIOD ticks),
+ * and the timer's prescaler must be set so the longest period fits in 16
+ * bits.
+ *
+ * @pre @p htim is initialized in PWM input mode, and its capture channels
+ *    are linked to circular, half-word DMA channels
+ *
+ * @param [in] capture pointer to the capture structure
+ * @param [in] htim timer handle
+ * @param [in] period_channel channel capturing the period (TIM_CHANNEL_x)
+ * @param [in] pulse_channel channel capturing the pulse width
+ *    (TIM_CHANNEL_x), or #MIROS_CAPTURE_NO_CHANNEL to measure the period only
+ * @param [in] clock timer's counter clock in Hz (after the prescaler)
+ * @param [in] periods buffer of @p size half-words for the periods
+ * @param [in] pulses buffer of @p size half-words for the pulse widths, or
+ *    NULL if @p pulse_channel isn't used
+ * @param [in] size number of half-words in each buffer
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the captures are started
+ * */
+HAL_StatusTypeDef MIROS_CaptureInitialize(Capture_t *capture,
+    TIM_HandleTypeDef *htim, uint32_t period_channel, uint32_t pulse_channel,
+    uint32_t clock, uint16_t *periods, uint16_t *pulses, uint32_t size);
+
+/**
+ * @brief No pulse channel, see #MIROS_CaptureInitialize()
+ * */
+#define MIROS_CAPTURE_NO_CHANNEL    0xFFFFFFFF
+
+/**
+ * @brief Process the edges captured since the previous update, and compute
+ * the averaged measurements. Called by the capture task, or by the
+ * application at its own rate.
+ *
+ * Read requests queued before the update complete with its measurements.
+ * Updates that keep the last measurements, while the signal hasn't timed
+ * out, don't complete any request.
+ *
+ * @param [in] capture pointer to the capture structure
+ *
+ * @return void
+ * */
+void MIROS_CaptureUpdate(Capture_t *capture);
+
+/**
+ * @brief Get the latest measurements of a capture channel
+ *
+ * @param [in] capture pointer to the capture structure
+ * @param [out] result pointer to receive the measurements
+ *
+ * @return void
+ * */
+void MIROS_CaptureGet(Capture_t *capture, CaptureResult_t *result);
+
+/**
+ * @brief Block until the next update of a capture channel, and get its
+ * measurements
+ *
+ * @pre Called from a task's context, not from an ISR, other than the task
+ *    updating the channel
+ *
+ * @param [in] capture pointer to the capture structure
+ * @param [out] result pointer to receive the measurements
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the measurements were read
+ * */
+HAL_StatusTypeDef MIROS_CaptureRead(Capture_t *capture,
+    CaptureResult_t *result);
+
+/**
+ * @brief Capture task handle, updates all initialized capture channels
+ * every #MIROS_CAPTURE_UPDATE_PERIOD ticks.
+ * */
+void MIROS_CaptureTask(void);
+
+#endif /* _INC_MIROS_CAPTURE_H_ */
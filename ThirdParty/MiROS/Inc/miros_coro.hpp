@@ -0,0 +1,678 @@
+/******************************************************************************
+ * @file    miros_coro.hpp
+ * @brief   MiROS C++20 coroutine executor, async flows inside one MiROS task
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_CORO_HPP_
+#define _INC_MIROS_CORO_HPP_
+
+/**
+ * Many small async flows (state machines) running inside one MiROS task,
+ * as C++20 coroutines. Each flow costs its coroutine frame (tens of bytes,
+ * from a fixed pool of #MIROS_CORO_FRAMES frames of #MIROS_CORO_FRAME_SIZE
+ * bytes) instead of a task stack.
+ *
+ * miros::coro::Async blink(uint32_t period) {
+ *   for (;;) {
+ *     HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
+ *     co_await miros::coro::delay(period);
+ *   }
+ * }
+ *
+ * static miros::coro::Executor Loop;
+ *
+ * void loop_task(void) {
+ *   Loop.spawn(blink(500));
+ *   Loop.run();
+ * }
+ *
+ * Flows await delays, coroutine semaphores and queues (posted from tasks,
+ * ISRs, or other flows), and I/O requests (DMA copies, flash, ...). A flow
+ * must not call blocking MiROS functions, that would block all the flows.
+ *
+ * > Requires miros.hpp, compiled with -std=c++20 (or gnu++20)
+ * */
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "miros.hpp"
+
+extern "C" {
+#include "miros_io.h"
+}
+
+/**
+ * @brief Number of coroutine frames, the maximum number of flows alive
+ * */
+#ifndef MIROS_CORO_FRAMES
+#define MIROS_CORO_FRAMES           32
+#endif
+
+/**
+ * @brief Coroutine frame size, in bytes. Flows with larger frames fail to
+ * be created.
+ * */
+#ifndef MIROS_CORO_FRAME_SIZE
+#define MIROS_CORO_FRAME_SIZE       64
+#endif
+
+namespace miros {
+namespace coro {
+
+class Executor;
+
+/**
+ * @brief Fixed pool of coroutine frames, handed out from the pool's storage
+ * the first time, then from a free list
+ * */
+class FramePool {
+ public:
+  static void* allocate(std::size_t size) noexcept {
+    CriticalSection critical;
+    Block *block = free_;
+
+    if (size > MIROS_CORO_FRAME_SIZE) {
+      return nullptr;
+    }
+
+    if (block != nullptr) {
+      free_ = block->next;
+    } else if (used_ < MIROS_CORO_FRAMES) {
+      block = &blocks_[used_++];
+    } else {
+      return nullptr;
+    }
+
+    return block->storage;
+  }
+
+  static void free(void *frame) noexcept {
+    CriticalSection critical;
+    Block *block = static_cast<Block*>(frame);
+
+    block->next = free_;
+    free_ = block;
+  }
+
+ private:
+  union Block {
+    Block *next;
+    alignas(std::max_align_t) unsigned char storage[MIROS_CORO_FRAME_SIZE];
+  };
+
+  static inline Block blocks_[MIROS_CORO_FRAMES] { };
+  static inline Block *free_ = nullptr;
+  static inline std::size_t used_ = 0;
+};
+
+/**
+ * @brief Async flow, a coroutine run by an executor. It starts suspended,
+ * runs once it's spawned, and its frame is freed when it returns.
+ * */
+class Async {
+ public:
+  struct promise_type {
+    Executor *executor = nullptr;
+
+    static void* operator new(std::size_t size) noexcept {
+      return FramePool::allocate(size);
+    }
+
+    static void operator delete(void *frame) noexcept {
+      FramePool::free(frame);
+    }
+
+    static Async get_return_object_on_allocation_failure() noexcept {
+      return Async();
+    }
+
+    Async get_return_object() noexcept {
+      return Async(Handle::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+      return { };
+    }
+
+    std::suspend_never final_suspend() noexcept {
+      return { };
+    }
+
+    void return_void() noexcept {
+    }
+
+    void unhandled_exception() noexcept {
+      Error_Handler();
+    }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Async() noexcept = default;
+
+  Async(Async &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {
+  }
+
+  Async& operator=(Async&&) = delete;
+
+  /* a flow that was never spawned is destroyed */
+  ~Async() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  /**
+   * @brief Check whether the flow was created (its frame was allocated)
+   * */
+  explicit operator bool() const noexcept {
+    return static_cast<bool>(handle_);
+  }
+
+ private:
+  friend class Executor;
+
+  explicit Async(Handle handle) noexcept
+      : handle_(handle) {
+  }
+
+  Handle release() noexcept {
+    return std::exchange(handle_, nullptr);
+  }
+
+  Handle handle_ { };
+};
+
+/**
+ * @brief Sleeping flow, woken up by the executor at tick `wake`
+ * */
+struct Sleeper {
+  Sleeper *next;
+  std::coroutine_handle<> handle;
+  std::uint32_t wake;
+};
+
+/**
+ * @brief Runs async flows inside the MiROS task that calls run(). Flows are
+ * resumed in the order they become ready. The task blocks while no flow is
+ * ready, and wakes up once every tick while flows are sleeping.
+ * */
+class Executor {
+ public:
+  constexpr Executor() noexcept = default;
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  /**
+   * @brief Start an async flow, can be called from any task
+   *
+   * @return bool: false if the flow wasn't created (frame pool is empty)
+   * */
+  bool spawn(Async &&async) noexcept {
+    Async::Handle handle = async.release();
+
+    if (!handle) {
+      return false;
+    }
+
+    handle.promise().executor = this;
+    schedule(handle);
+
+    return true;
+  }
+
+  /**
+   * @brief Make a suspended flow ready, can be called from any context
+   * (tasks, ISRs)
+   * */
+  void schedule(std::coroutine_handle<> handle) noexcept {
+    CriticalSection critical;
+
+    assert_param(count_ < MIROS_CORO_FRAMES);
+    ready_[tail_] = handle;
+    tail_ = (tail_ + 1 == MIROS_CORO_FRAMES) ? 0 : tail_ + 1;
+    count_ = count_ + 1;
+
+    if (waiting_) {
+      waiting_ = false;
+      wake_.post();
+    }
+  }
+
+  /**
+   * @brief Put the running flow to sleep until tick @p wake, called by
+   * delay()
+   * */
+  void sleep(Sleeper *sleeper) noexcept {
+    sleeper->next = sleepers_;
+    sleepers_ = sleeper;
+  }
+
+  /**
+   * @brief Run the flows, never returns
+   * */
+  [[noreturn]] void run() noexcept {
+    for (;;) {
+      std::coroutine_handle<> handle;
+
+      while (next(handle)) {
+        handle.resume();
+      }
+
+      wakeSleepers();
+
+      if (sleepers_ != nullptr) {
+        if (count_ == 0) {
+          MIROS_TaskDelay(1);
+        }
+      } else if (idle()) {
+        wake_.wait();
+      }
+    }
+  }
+
+ private:
+  bool next(std::coroutine_handle<> &handle) noexcept {
+    CriticalSection critical;
+
+    if (count_ == 0) {
+      return false;
+    }
+
+    handle = ready_[head_];
+    head_ = (head_ + 1 == MIROS_CORO_FRAMES) ? 0 : head_ + 1;
+    count_ = count_ - 1;
+
+    return true;
+  }
+
+  /* sleepers are only touched from the executor's task */
+  void wakeSleepers() noexcept {
+    std::uint32_t now = HAL_GetTick();
+    Sleeper **link = &sleepers_;
+
+    while (*link != nullptr) {
+      Sleeper *sleeper = *link;
+
+      if (static_cast<std::int32_t>(now - sleeper->wake) >= 0) {
+        *link = sleeper->next;
+        schedule(sleeper->handle);
+      } else {
+        link = &sleeper->next;
+      }
+    }
+  }
+
+  /* no ready flow, wait for schedule() to post the wake up semaphore */
+  bool idle() noexcept {
+    CriticalSection critical;
+
+    waiting_ = (count_ == 0);
+
+    return waiting_;
+  }
+
+  std::coroutine_handle<> ready_[MIROS_CORO_FRAMES] { };
+  std::size_t head_ = 0;
+  std::size_t tail_ = 0;
+  volatile std::size_t count_ = 0;
+  bool waiting_ = false;
+  Sleeper *sleepers_ = nullptr;
+  miros::Semaphore wake_ { 0 };
+};
+
+/**
+ * @brief Awaitable delay, suspends the flow for @p ticks
+ * */
+class Delay {
+ public:
+  explicit Delay(std::uint32_t ticks) noexcept
+      : ticks_(ticks) {
+  }
+
+  bool await_ready() const noexcept {
+    return ticks_ == 0;
+  }
+
+  void await_suspend(Async::Handle handle) noexcept {
+    sleeper_.handle = handle;
+    sleeper_.wake = HAL_GetTick() + ticks_;
+    handle.promise().executor->sleep(&sleeper_);
+  }
+
+  void await_resume() const noexcept {
+  }
+
+ private:
+  std::uint32_t ticks_;
+  Sleeper sleeper_ { };
+};
+
+inline Delay delay(std::uint32_t ticks) noexcept {
+  return Delay(ticks);
+}
+
+/**
+ * @brief Coroutine semaphore: flows wait on it without blocking the
+ * executor's task, tasks and ISRs post it
+ * */
+class Semaphore {
+  struct Waiter {
+    Waiter *next;
+    std::coroutine_handle<> handle;
+    Executor *executor;
+  };
+
+ public:
+  class Awaiter {
+   public:
+    explicit Awaiter(Semaphore &sem) noexcept
+        : sem_(sem) {
+    }
+
+    bool await_ready() noexcept {
+      return sem_.tryWait();
+    }
+
+    /* a token posted since await_ready() resumes the flow at once */
+    bool await_suspend(Async::Handle handle) noexcept {
+      waiter_.handle = handle;
+      waiter_.executor = handle.promise().executor;
+      return sem_.enqueue(&waiter_);
+    }
+
+    void await_resume() const noexcept {
+    }
+
+   private:
+    Semaphore &sem_;
+    Waiter waiter_ { };
+  };
+
+  explicit constexpr Semaphore(std::uint32_t count = 0) noexcept
+      : count_(count) {
+  }
+
+  Semaphore(const Semaphore&) = delete;
+  Semaphore& operator=(const Semaphore&) = delete;
+
+  /**
+   * @brief Wait for a token, `co_await sem.wait()`
+   * */
+  Awaiter wait() noexcept {
+    return Awaiter(*this);
+  }
+
+  bool tryWait() noexcept {
+    CriticalSection critical;
+
+    if (count_ == 0) {
+      return false;
+    }
+    count_--;
+
+    return true;
+  }
+
+  /**
+   * @brief Post a token, hands it to the first waiting flow, if any. Can be
+   * called from any context.
+   * */
+  void post() noexcept {
+    CriticalSection critical;
+    Waiter *waiter = head_;
+
+    if (waiter == nullptr) {
+      count_++;
+      return;
+    }
+
+    head_ = waiter->next;
+    if (head_ == nullptr) {
+      tail_ = nullptr;
+    }
+    waiter->executor->schedule(waiter->handle);
+  }
+
+  std::uint32_t count() const noexcept {
+    return count_;
+  }
+
+ private:
+  bool enqueue(Waiter *waiter) noexcept {
+    CriticalSection critical;
+
+    if (count_ > 0) {
+      count_--;
+      return false;
+    }
+
+    waiter->next = nullptr;
+    if (tail_ == nullptr) {
+      head_ = waiter;
+    } else {
+      tail_->next = waiter;
+    }
+    tail_ = waiter;
+
+    return true;
+  }
+
+  std::uint32_t count_;
+  Waiter *head_ = nullptr;
+  Waiter *tail_ = nullptr;
+};
+
+/**
+ * @brief Coroutine FIFO queue of @p N items of type @p T. Flows await push
+ * and pop, tasks and ISRs use tryPush() and tryPop().
+ * */
+template <typename T, std::size_t N>
+class Queue {
+  static_assert(N > 0, "queue can't be empty");
+
+ public:
+  class PushAwaiter {
+   public:
+    PushAwaiter(Queue &queue, const T &item) noexcept
+        : queue_(queue), item_(item), slot_(queue.slots_) {
+    }
+
+    bool await_ready() noexcept {
+      return slot_.await_ready();
+    }
+
+    bool await_suspend(Async::Handle handle) noexcept {
+      return slot_.await_suspend(handle);
+    }
+
+    void await_resume() noexcept {
+      queue_.put(item_);
+    }
+
+   private:
+    Queue &queue_;
+    T item_;
+    Semaphore::Awaiter slot_;
+  };
+
+  class PopAwaiter {
+   public:
+    explicit PopAwaiter(Queue &queue) noexcept
+        : queue_(queue), item_(queue.items_) {
+    }
+
+    bool await_ready() noexcept {
+      return item_.await_ready();
+    }
+
+    bool await_suspend(Async::Handle handle) noexcept {
+      return item_.await_suspend(handle);
+    }
+
+    T await_resume() noexcept {
+      return queue_.get();
+    }
+
+   private:
+    Queue &queue_;
+    Semaphore::Awaiter item_;
+  };
+
+  constexpr Queue() noexcept
+      : slots_(N), items_(0) {
+  }
+
+  Queue(const Queue&) = delete;
+  Queue& operator=(const Queue&) = delete;
+
+  /**
+   * @brief Push an item, `co_await queue.push(item)`
+   * */
+  PushAwaiter push(const T &item) noexcept {
+    return PushAwaiter(*this, item);
+  }
+
+  /**
+   * @brief Pop an item, `T item = co_await queue.pop()`
+   * */
+  PopAwaiter pop() noexcept {
+    return PopAwaiter(*this);
+  }
+
+  bool tryPush(const T &item) noexcept {
+    if (!slots_.tryWait()) {
+      return false;
+    }
+    put(item);
+    return true;
+  }
+
+  bool tryPop(T &item) noexcept {
+    if (!items_.tryWait()) {
+      return false;
+    }
+    item = get();
+    return true;
+  }
+
+ private:
+  void put(const T &item) noexcept {
+    {
+      CriticalSection critical;
+      buffer_[tail_] = item;
+      tail_ = (tail_ + 1 == N) ? 0 : tail_ + 1;
+    }
+    items_.post();
+  }
+
+  T get() noexcept {
+    T item;
+    {
+      CriticalSection critical;
+      item = buffer_[head_];
+      head_ = (head_ + 1 == N) ? 0 : head_ + 1;
+    }
+    slots_.post();
+    return item;
+  }
+
+  Semaphore slots_;
+  Semaphore items_;
+  std::size_t head_ = 0;
+  std::size_t tail_ = 0;
+  T buffer_[N] { };
+};
+
+/**
+ * @brief Awaitable I/O request: submits the request, and resumes the flow
+ * from the request's completion callback. Evaluates to the request's
+ * completion status.
+ *
+ * > The request's callback and context are used by the awaiter
+ * */
+class IoAwaiter {
+ public:
+  IoAwaiter(IoDevice_t *device, IoRequest_t *request) noexcept
+      : device_(device), request_(request) {
+  }
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+
+  void await_suspend(Async::Handle handle) noexcept {
+    handle_ = handle;
+    executor_ = handle.promise().executor;
+    MIROS_IoSubmit(device_, request_, &IoAwaiter::complete, this);
+  }
+
+  HAL_StatusTypeDef await_resume() const noexcept {
+    return request_->status;
+  }
+
+ private:
+  static void complete(IoRequest_t *request) {
+    IoAwaiter *awaiter = static_cast<IoAwaiter*>(request->context);
+
+    awaiter->executor_->schedule(awaiter->handle_);
+  }
+
+  IoDevice_t *device_;
+  IoRequest_t *request_;
+  std::coroutine_handle<> handle_ { };
+  Executor *executor_ = nullptr;
+};
+
+/**
+ * @brief Transfer an I/O request, `co_await transfer(device, &request)`
+ * */
+inline IoAwaiter transfer(IoDevice_t *device, IoRequest_t *request) noexcept {
+  return IoAwaiter(device, request);
+}
+
+/**
+ * @brief Copy @p length data items by DMA (a miros_dma.h device), using
+ * @p request, that must live in the flow's frame (or longer) until the copy
+ * completes, `co_await dmaCopy(&dma, &request, destination, source, length)`
+ * */
+inline IoAwaiter dmaCopy(IoDevice_t *device, IoRequest_t *request,
+    void *destination, const void *source, std::uint32_t length) noexcept {
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(destination);
+
+  MIROS_IoRequestInitialize(request, MIROS_IO_WRITE,
+      static_cast<std::uint32_t>(address), const_cast<void*>(source), length);
+  return IoAwaiter(device, request);
+}
+
+} /* namespace coro */
+} /* namespace miros */
+
+#endif /* _INC_MIROS_CORO_HPP_ */
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * @file    miros_dma.h
+ * @brief   MiROS DMA memory-to-memory copy device, on MiROS I/O requests
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_DMA_H_
+#define _INC_MIROS_DMA_H_
+
+/**
+ * @brief Initialize a DMA copy device, on a DMA channel configured for
+ * memory-to-memory transfers.
+ *
+ * Requests operations: MIROS_IO_READ copies `length` data items from
+ * `address` to `buffer`, MIROS_IO_WRITE copies `length` data items from
+ * `buffer` to `address`. The data item size is the one configured in
+ * @p hdma.
+ *
+ * Queued requests are started from the DMA transfer complete interrupt, so
+ * the DMA channel stays busy back-to-back.
+ *
+ * @pre @p hdma is initialized (HAL_DMA_Init()) with DMA_MEMORY_TO_MEMORY
+ *    direction, and its IRQ handler calls HAL_DMA_IRQHandler()
+ *
+ * @param [in] device pointer to the device structure
+ * @param [in] hdma DMA channel handle
+ *
+ * @return void
+ * */
+void MIROS_DmaInitialize(IoDevice_t *device, DMA_HandleTypeDef *hdma);
+
+/**
+ * @brief Copy @p length data items from @p source to @p destination, and
+ * block until the copy is complete
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] device pointer to the DMA copy device
+ * @param [out] destination copy destination
+ * @param [in] source copy source
+ * @param [in] length number of data items to copy
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the data was copied
+ * */
+HAL_StatusTypeDef MIROS_DmaCopy(IoDevice_t *device, void *destination,
+    const void *source, uint32_t length);
+
+#endif /* _INC_MIROS_DMA_H_ */
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * @file    miros_event.h
+ * @brief   Events, event pools and event queues
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_EVENT_H_
+#define _INC_MIROS_EVENT_H_
+
+/**
+ * Events are passed by reference, without copying. An event is either
+ * static (a `const` event, or one that lives forever), or dynamic: taken
+ * from an event pool by #MIROS_EventNew(), reference counted by the event
+ * queues holding it, and returned to its pool by #MIROS_EventGc() once the
+ * last receiver is done with it.
+ *
+ * Events with parameters extend Event_t:
+ *
+ * typedef struct {
+ *   Event_t super;
+ *   uint16_t sample;
+ * } SampleEvent_t;
+ *
+ * SampleEvent_t *event = (SampleEvent_t*) MIROS_EventNew(
+ *     sizeof(SampleEvent_t), SAMPLE_SIGNAL);
+ *
+ * Dynamic events are immutable once posted, receivers only read them.
+ *
+ * > Requires miros.h and miros_sem.h to be included first
+ * */
+
+/**
+ * @brief Maximum number of event pools
+ * */
+#ifndef MIROS_EVENT_POOLS
+#define MIROS_EVENT_POOLS           3
+#endif
+
+/**
+ * @brief Reserved signals, application signals start at #MIROS_SIGNAL_USER
+ * */
+#define MIROS_SIGNAL_INIT           0
+#define MIROS_SIGNAL_ENTRY          1
+#define MIROS_SIGNAL_EXIT           2
+#define MIROS_SIGNAL_USER           4
+
+/**
+ * @brief Event
+ *
+ * uint16_t signal: event's signal
+ * uint8_t pool: event's pool, 1 based, 0 for static events
+ * uint8_t ref_count: number of event queues holding the event
+ * */
+typedef struct {
+  uint16_t signal;
+  uint8_t pool;
+  volatile uint8_t ref_count;
+} Event_t;
+
+/**
+ * @brief Event queue, a FIFO of event references
+ *
+ * Event_t ** buffer: queue's storage
+ * uint32_t length: queue's length
+ * uint32_t head: index of the oldest event
+ * uint32_t tail: index of the next free slot
+ * uint32_t used: number of queued events
+ * uint32_t max_used: highest number of queued events, for sizing the queue
+ * Semaphore_t items: counts queued events, the receiver waits on it
+ * Semaphore_t * ready: also posted for every posted event, shared by queues
+ *    that one receiver waits on together, NULL if none
+ * */
+typedef struct {
+  Event_t **buffer;
+  uint32_t length;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t used;
+  uint32_t max_used;
+  Semaphore_t items;
+  Semaphore_t *ready;
+} EventQueue_t;
+
+/**
+ * @brief Initialize a static event
+ * */
+#define MIROS_EVENT_STATIC(sig)     { .signal = (sig), .pool = 0, .ref_count = 0 }
+
+/**
+ * @brief Add an event pool of @p count blocks of @p block_size bytes. Pools
+ * must be added in increasing block size order, before events are used.
+ *
+ * @param [in] storage pointer to the pool's storage, @p count * @p block_size
+ *    bytes
+ * @param [in] block_size block size, in bytes, a multiple of 4, at least
+ *    sizeof(Event_t)
+ * @param [in] count number of blocks
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the pool was added, HAL_ERROR if
+ *    there are already #MIROS_EVENT_POOLS pools, or the block size is
+ *    invalid
+ * */
+HAL_StatusTypeDef MIROS_EventPoolInitialize(uint32_t *storage,
+    uint32_t block_size, uint32_t count);
+
+/**
+ * @brief Take an event of at least @p size bytes from the smallest pool
+ * that has a free block. Doesn't block, can be called from ISRs.
+ *
+ * @param [in] size event's size, in bytes
+ * @param [in] signal event's signal
+ *
+ * @return Event_t *: pointer to the event, or NULL if no pool has a free
+ *    block large enough
+ * */
+Event_t* MIROS_EventNew(uint32_t size, uint16_t signal);
+
+/**
+ * @brief Release a reference to @p event, the event is returned to its
+ * pool when it's not referenced anymore. Static events are ignored.
+ *
+ * Called by receivers once they're done with an event, and by senders for
+ * new events that weren't posted.
+ *
+ * @param [in] event pointer to the event
+ *
+ * @return void
+ * */
+void MIROS_EventGc(Event_t *event);
+
+/**
+ * @brief Get the lowest number of free blocks of a pool, for sizing pools
+ *
+ * @param [in] pool pool's index, in the order pools were added
+ *
+ * @return uint32_t: lowest number of free blocks
+ * */
+uint32_t MIROS_EventPoolMinFree(uint32_t pool);
+
+/**
+ * @brief Initialize an event queue
+ *
+ * @param [in] queue pointer to the queue
+ * @param [in] buffer pointer to the queue's storage
+ * @param [in] length queue's length
+ *
+ * @return void
+ * */
+void MIROS_EventQueueInitialize(EventQueue_t *queue, Event_t **buffer,
+    uint32_t length);
+
+/**
+ * @brief Post @p event to @p queue, the queue holds a reference to the
+ * event. Doesn't block, can be called from ISRs.
+ *
+ * @param [in] queue pointer to the queue
+ * @param [in] event pointer to the event
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the event was posted, HAL_ERROR if
+ *    the queue is full (the event isn't referenced)
+ * */
+HAL_StatusTypeDef MIROS_EventQueuePost(EventQueue_t *queue, Event_t *event);
+
+/**
+ * @brief Get the oldest event from @p queue, blocks the running task until
+ * an event is available. The receiver calls #MIROS_EventGc() once it's done
+ * with the event.
+ *
+ * @param [in] queue pointer to the queue
+ *
+ * @return Event_t *: pointer to the event
+ * */
+Event_t* MIROS_EventQueueGet(EventQueue_t *queue);
+
+/**
+ * @brief Get the oldest event from @p queue, if any, without blocking
+ *
+ * @param [in] queue pointer to the queue
+ *
+ * @return Event_t *: pointer to the event, or NULL if the queue is empty
+ * */
+Event_t* MIROS_EventQueueTryGet(EventQueue_t *queue);
+
+#endif /* _INC_MIROS_EVENT_H_ */
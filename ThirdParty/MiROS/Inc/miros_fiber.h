@@ -0,0 +1,165 @@
+/******************************************************************************
+ * @file    miros_fiber.h
+ * @brief   Cooperative fibers, multiplexed inside one MiROS task
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_FIBER_H_
+#define _INC_MIROS_FIBER_H_
+
+/**
+ * Fibers are user-level threads with small stacks, for blocking-style code
+ * (protocol handlers, legacy drivers) that can't be turned into state
+ * machines or coroutines. All fibers run inside the MiROS task that calls
+ * #MIROS_FiberRun(), and switch cooperatively: a fiber runs until it calls
+ * #MIROS_FiberYield(), #MIROS_FiberDelay() or #MIROS_FiberSemWait(), or
+ * returns.
+ *
+ * A fiber switch is a plain function call that saves R3-R11 and LR on the
+ * fiber's stack (R3 keeps the stack 8 byte aligned) and swaps SP, there's no exception entry, no scheduler
+ * decision and no critical section, which is a fraction of a PendSV task
+ * switch. Fibers switch through the scheduler loop (fiber -> #MIROS_FiberRun()
+ * -> next fiber).
+ *
+ * Fibers must not call blocking MiROS functions, that would block all the
+ * fibers. Sleeping fibers are woken up by the scheduler's loop, which
+ * blocks its task for 1 tick at a time when no fiber is ready.
+ *
+ * > Requires miros.h and miros_sem.h to be included first
+ * */
+
+/**
+ * @brief Minimum fiber stack size, in words. The running fiber's stack is
+ * the hosting task's stack (PSP), and must hold, on top of the fiber's own
+ * function frames:
+ * - the switch frame, R3-R11 and LR (10 words)
+ * - the hosting task's context, when it's preempted: the exception frame
+ *   (8 words, 9 if realigned) and the registers saved by PendSV (R4-R11,
+ *   8 words)
+ *
+ * Interrupt handlers run on MSP, so nested interrupts don't add to it. That
+ * leaves 21 words for the fiber's function, larger functions need larger
+ * stacks.
+ * */
+#define MIROS_FIBER_MIN_STACK_SIZE  48
+
+/**
+ * @brief Fiber states
+ * */
+#define MIROS_FIBER_READY           0
+#define MIROS_FIBER_SLEEPING        1
+#define MIROS_FIBER_DONE            2
+
+/**
+ * @brief Fiber's function
+ *
+ * @param [in] argument fiber's argument, given to #MIROS_FiberCreate()
+ * */
+typedef void (*FiberHandle_t)(void *argument);
+
+/**
+ * @brief Fiber
+ *
+ * uint32_t * stack_ptr: fiber's saved stack pointer, while it's switched out
+ * struct Fiber * next: next fiber, in the scheduler's list
+ * FiberHandle_t handle: fiber's function
+ * void * argument: fiber's function argument
+ * uint32_t state: fiber's state, one of MIROS_FIBER_*
+ * uint32_t wake: tick at which a sleeping fiber is woken up
+ * */
+typedef struct Fiber {
+  uint32_t *stack_ptr;
+  struct Fiber *next;
+  FiberHandle_t handle;
+  void *argument;
+  uint32_t state;
+  uint32_t wake;
+} Fiber_t;
+
+/**
+ * @brief Create a fiber, it's run by #MIROS_FiberRun() in creation order.
+ * Can be called before #MIROS_FiberRun(), or from a running fiber.
+ *
+ * @param [in] fiber pointer to the fiber
+ * @param [in] handle fiber's function
+ * @param [in] argument fiber's function argument
+ * @param [in] stack pointer to the fiber's stack
+ * @param [in] stack_size stack size, in words, at least
+ *    #MIROS_FIBER_MIN_STACK_SIZE
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the fiber was created, HAL_ERROR if
+ *    the stack is too small
+ * */
+HAL_StatusTypeDef MIROS_FiberCreate(Fiber_t *fiber, FiberHandle_t handle,
+    void *argument, uint32_t *stack, uint32_t stack_size);
+
+/**
+ * @brief Run the fibers in the calling task, round robin, until all of them
+ * return
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_FiberRun(void);
+
+/**
+ * @brief Switch to the next ready fiber, the calling fiber stays ready
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_FiberYield(void);
+
+/**
+ * @brief Suspend the calling fiber for @p ticks
+ *
+ * @param [in] ticks number of ticks to sleep
+ *
+ * @return void
+ * */
+void MIROS_FiberDelay(uint32_t ticks);
+
+/**
+ * @brief Wait for a semaphore without blocking the other fibers. The
+ * semaphore is polled once every tick.
+ *
+ * @param [in] sem pointer to the semaphore
+ *
+ * @return void
+ * */
+void MIROS_FiberSemWait(Semaphore_t *sem);
+
+/**
+ * @brief Get the running fiber
+ *
+ * @param void
+ *
+ * @return Fiber_t *: pointer to the running fiber, or NULL if called
+ *    outside of a fiber
+ * */
+Fiber_t* MIROS_FiberSelf(void);
+
+#endif /* _INC_MIROS_FIBER_H_ */
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * @file    miros_flash.h
+ * @brief   MiROS non-blocking internal flash programming service
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_FLASH_H_
+#define _INC_MIROS_FLASH_H_
+
+/**
+ * @brief Default flash interrupt priority. Lowest priority, so any other
+ * interrupt can preempt the flash ISR, while it starts the next queued
+ * flash operation.
+ * */
+#define MIROS_FLASH_IRQ_PRIORITY    15
+
+/**
+ * @brief Initialize MiROS flash service
+ *
+ * Copies the vector table into RAM and relocates it (SCB->VTOR), as the
+ * CPU can't fetch the interrupt vectors from flash while the flash is being
+ * programmed or erased. Then enables the flash interrupt.
+ *
+ * Any instruction fetch from flash while the flash is busy stalls the bus
+ * until the operation is complete (up to about 20 ms for a page erase), and
+ * a CPU stalled on a fetch services no interrupt. So, while a flash request
+ * is in progress, only code running from RAM makes progress. The flash
+ * driver (driving the flash controller's registers, not HAL flash driver),
+ * its interrupt handler, the blocking request path of #MIROS_FlashProgram()
+ * and #MIROS_FlashErase(), the kernel tick, the semaphores and the context
+ * switch are placed in RAM, using #MIROS_RAMFUNC.
+ *
+ * To keep servicing interrupts during flash operations, the idle task, and
+ * the interrupt handlers that must be serviced (and all the functions they
+ * call) must be placed in RAM too. Tasks running from flash stall until the
+ * operation is complete.
+ *
+ * @pre HAL is initialized
+ * @pre Called before any other MiROS flash function
+ *
+ * @param [in] irq_priority flash interrupt preemption priority
+ *
+ * @return void
+ * */
+void MIROS_FlashInitialize(uint32_t irq_priority);
+
+/**
+ * @brief Get the flash I/O device, to submit asynchronous requests with
+ * #MIROS_IoSubmit().
+ *
+ * Requests operations: MIROS_IO_WRITE programs `length` half-words from
+ * `buffer` (in RAM) to `address`, MIROS_IO_ERASE erases `length` pages
+ * starting from the page at `address`.
+ *
+ * @pre #MIROS_FlashInitialize() was called
+ *
+ * @param void
+ *
+ * @return IoDevice_t *: pointer to the flash device
+ * */
+IoDevice_t* MIROS_FlashGetDevice(void);
+
+/**
+ * @brief Program @p count half-words into the flash memory, starting from
+ * @p address. The request is queued, and the calling task is blocked until
+ * the request is complete. Only code running from RAM executes while the
+ * flash is being programmed (see #MIROS_FlashInitialize()).
+ *
+ * @pre #MIROS_FlashInitialize() was called
+ * @pre Called from a task's context, not from an ISR
+ * @pre Programmed flash locations are erased
+ *
+ * @param [in] address flash address to program, must be half-word aligned
+ *    (HAL_ERROR otherwise)
+ * @param [in] data pointer to the data to be programmed, must not be located
+ *    in the flash memory
+ * @param [in] count number of half-words to program
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if all half-words are programmed,
+ *    HAL_ERROR otherwise (use #MIROS_FlashGetError() to get error details)
+ * */
+HAL_StatusTypeDef MIROS_FlashProgram(uint32_t address, const uint16_t *data,
+    uint32_t count);
+
+/**
+ * @brief Erase @p nb_pages flash pages, starting from the page at
+ * @p page_address. The request is queued, and the calling task is blocked
+ * until the request is complete. Only code running from RAM executes while
+ * the flash is being erased (see #MIROS_FlashInitialize()).
+ *
+ * @pre #MIROS_FlashInitialize() was called
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] page_address address of the first page to erase
+ * @param [in] nb_pages number of pages to erase
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if all pages are erased,
+ *    HAL_ERROR otherwise (use #MIROS_FlashGetError() to get error details)
+ * */
+HAL_StatusTypeDef MIROS_FlashErase(uint32_t page_address, uint32_t nb_pages);
+
+/**
+ * @brief Get the error flags of the last failed flash operation
+ *
+ * @param void
+ *
+ * @return uint32_t: FLASH_SR_PGERR (programming a location that isn't
+ *    erased), FLASH_SR_WRPRTERR (write protected page), or 0 if the last
+ *    operation didn't fail
+ * */
+uint32_t MIROS_FlashGetError(void);
+
+/**
+ * @brief Flash interrupt handler, placed in RAM. Starts the next half-word
+ * or page of the request in progress, or completes the request.
+ * */
+void FLASH_IRQHandler(void);
+
+#endif /* _INC_MIROS_FLASH_H_ */
@@ -0,0 +1,256 @@
+/******************************************************************************
+ * @file    miros_hsm.h
+ * @brief   Hierarchical state machines, with time events
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_HSM_H_
+#define _INC_MIROS_HSM_H_
+
+/**
+ * Table driven hierarchical state machines. Each state has a parent (NULL
+ * for top level states), entry and exit actions, an initial transition to
+ * one of its substates (composite states), and a table of transitions:
+ *
+ * static HsmTransition_t OnTransitions[] = {
+ *   { .signal = BUTTON_SIGNAL, .target = &Off },
+ *   { .signal = TIMEOUT_SIGNAL, .action = blink },
+ * };
+ *
+ * static HsmState_t On = {
+ *   .parent = &Powered,
+ *   .entry = led_on,
+ *   .transitions = OnTransitions,
+ *   .num_transitions = 2,
+ * };
+ *
+ * An event is handled by the first transition of the current state whose
+ * signal matches and whose guard (if any) is true, otherwise by the
+ * state's parent, and so on up to the top level state. Transitions without
+ * a target are internal: only their action runs.
+ *
+ * #MIROS_HsmPrepare() finds the least common ancestor of each transition's
+ * source and target once, at startup, and stores it in the transition. So
+ * a transition exits states up to the ancestor, and enters states down to
+ * the target, without searching at run time, and its cost is bounded by
+ * the states' depth. A transition to the source state itself exits and
+ * re-enters it, a transition to a substate of the source doesn't exit the
+ * source (local transition).
+ *
+ * A state machine runs standalone, by calling #MIROS_HsmDispatch() from any
+ * task, or inside an active object, whose dispatch function calls
+ * #MIROS_HsmDispatch() (which starts the state machine on
+ * #MIROS_SIGNAL_INIT). Time events post their event to an event queue
+ * (usually the active object's) when their software timer expires.
+ *
+ * > Requires miros.h, miros_sem.h, miros_event.h and miros_timer.h to be
+ * > included first
+ * */
+
+/**
+ * @brief Maximum state nesting depth
+ * */
+#ifndef MIROS_HSM_MAX_DEPTH
+#define MIROS_HSM_MAX_DEPTH         8
+#endif
+
+struct Hsm;
+
+/**
+ * @brief Action: entry and exit actions (with #MIROS_SIGNAL_ENTRY and
+ * #MIROS_SIGNAL_EXIT events), initial transition actions (with
+ * #MIROS_SIGNAL_INIT), and transition actions (with the transition's
+ * event)
+ * */
+typedef void (*HsmAction_t)(struct Hsm *me, const Event_t *event);
+
+/**
+ * @brief Transition guard
+ *
+ * @return uint32_t: non zero if the transition is enabled
+ * */
+typedef uint32_t (*HsmGuard_t)(struct Hsm *me, const Event_t *event);
+
+struct HsmState;
+
+/**
+ * @brief Transition
+ *
+ * uint16_t signal: triggering signal
+ * HsmGuard_t guard: transition's guard, or NULL
+ * HsmAction_t action: transition's action, or NULL
+ * const struct HsmState * target: target state, NULL for internal
+ *    transitions
+ * const struct HsmState * lca: least common ancestor of the source and the
+ *    target states (NULL for the top level), set by #MIROS_HsmPrepare()
+ * */
+typedef struct {
+  uint16_t signal;
+  HsmGuard_t guard;
+  HsmAction_t action;
+  const struct HsmState *target;
+  const struct HsmState *lca;
+} HsmTransition_t;
+
+/**
+ * @brief State
+ *
+ * const struct HsmState * parent: parent state, NULL for top level states
+ * HsmAction_t entry: entry action, or NULL
+ * HsmAction_t exit: exit action, or NULL
+ * HsmAction_t init: initial transition action, or NULL
+ * const struct HsmState * initial: initial substate of composite states,
+ *    NULL for leaf states
+ * HsmTransition_t * transitions: state's transitions, in priority order
+ * uint32_t num_transitions: number of transitions
+ * */
+typedef struct HsmState {
+  const struct HsmState *parent;
+  HsmAction_t entry;
+  HsmAction_t exit;
+  HsmAction_t init;
+  const struct HsmState *initial;
+  HsmTransition_t *transitions;
+  uint32_t num_transitions;
+} HsmState_t;
+
+/**
+ * @brief State machine
+ *
+ * const HsmState_t * state: current (leaf) state, NULL until started
+ * const HsmState_t * initial: initial state
+ * void * context: application's data, for the actions
+ * */
+typedef struct Hsm {
+  const HsmState_t *state;
+  const HsmState_t *initial;
+  void *context;
+} Hsm_t;
+
+/**
+ * @brief Time event, posted to an event queue when its timer expires
+ *
+ * Timer_t timer: time event's software timer
+ * Event_t event: posted event (static)
+ * EventQueue_t * queue: queue the event is posted to
+ * */
+typedef struct {
+  Timer_t timer;
+  Event_t event;
+  EventQueue_t *queue;
+} TimeEvent_t;
+
+/**
+ * @brief Compute the least common ancestor of all the transitions of
+ * @p states, once before the state machines using them are started
+ *
+ * @param [in] states array of pointers to all the states
+ * @param [in] count number of states
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the states were prepared, HAL_ERROR
+ *    if a state is nested deeper than #MIROS_HSM_MAX_DEPTH
+ * */
+HAL_StatusTypeDef MIROS_HsmPrepare(HsmState_t *const *states,
+    uint32_t count);
+
+/**
+ * @brief Initialize a state machine, it's started by #MIROS_HsmStart(), or
+ * by dispatching a #MIROS_SIGNAL_INIT event
+ *
+ * @param [in] hsm pointer to the state machine
+ * @param [in] initial initial state
+ * @param [in] context application's data
+ *
+ * @return void
+ * */
+void MIROS_HsmInitialize(Hsm_t *hsm, const HsmState_t *initial,
+    void *context);
+
+/**
+ * @brief Enter the initial state, then follow initial transitions down to
+ * a leaf state
+ *
+ * @param [in] hsm pointer to the state machine
+ *
+ * @return void
+ * */
+void MIROS_HsmStart(Hsm_t *hsm);
+
+/**
+ * @brief Dispatch @p event to the state machine, run to completion
+ *
+ * @param [in] hsm pointer to the state machine
+ * @param [in] event pointer to the event
+ *
+ * @return uint32_t: 1 if the event was handled, 0 if it was ignored
+ * */
+uint32_t MIROS_HsmDispatch(Hsm_t *hsm, const Event_t *event);
+
+/**
+ * @brief Check whether the state machine is in @p state, or in one of its
+ * substates
+ *
+ * @param [in] hsm pointer to the state machine
+ * @param [in] state pointer to the state
+ *
+ * @return uint32_t: 1 if the state machine is in @p state, 0 otherwise
+ * */
+uint32_t MIROS_HsmIsIn(const Hsm_t *hsm, const HsmState_t *state);
+
+/**
+ * @brief Initialize a time event, disarmed
+ *
+ * @param [in] time_event pointer to the time event
+ * @param [in] signal posted event's signal
+ * @param [in] queue queue the event is posted to
+ *
+ * @return void
+ * */
+void MIROS_TimeEventInitialize(TimeEvent_t *time_event, uint16_t signal,
+    EventQueue_t *queue);
+
+/**
+ * @brief Arm the time event to be posted after @p ticks, then every
+ * @p period ticks
+ *
+ * @param [in] time_event pointer to the time event
+ * @param [in] ticks number of ticks until the event is posted, at least 1
+ * @param [in] period number of ticks between posts, 0 to post once
+ *
+ * @return void
+ * */
+void MIROS_TimeEventArm(TimeEvent_t *time_event, uint32_t ticks,
+    uint32_t period);
+
+/**
+ * @brief Disarm the time event. An event posted before it was disarmed
+ * stays in the queue.
+ *
+ * @param [in] time_event pointer to the time event
+ *
+ * @return uint32_t: 1 if the time event was armed, 0 otherwise
+ * */
+uint32_t MIROS_TimeEventDisarm(TimeEvent_t *time_event);
+
+#endif /* _INC_MIROS_HSM_H_ */
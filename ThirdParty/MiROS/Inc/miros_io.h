@@ -0,0 +1,200 @@
+/******************************************************************************
+ * @file    miros_io.h
+ * @brief   MiROS asynchronous I/O requests and per-device request queues
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_IO_H_
+#define _INC_MIROS_IO_H_
+
+/**
+ * @brief I/O operations, interpreted by each device driver
+ * */
+typedef enum {
+  MIROS_IO_READ = 0,
+  MIROS_IO_WRITE,
+  MIROS_IO_ERASE,
+  MIROS_IO_CONTROL,
+} IoOperation_t;
+
+struct IoRequest;
+struct IoDevice;
+
+/**
+ * @brief Request completion callback, called from the context that completed
+ * the request (usually the device's ISR)
+ * */
+typedef void (*IoCallback_t)(struct IoRequest *request);
+
+/**
+ * @brief Driver function that starts a request on the device's hardware.
+ * Called from task context when the device is idle, or from the device's
+ * ISR, right after the previous request completes.
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the request is started, the request
+ *    is completed with HAL_ERROR otherwise
+ * */
+typedef HAL_StatusTypeDef (*IoStart_t)(struct IoDevice *device,
+    struct IoRequest *request);
+
+/**
+ * @brief Driver function called when the device's request queue is empty
+ * */
+typedef void (*IoIdle_t)(struct IoDevice *device);
+
+/**
+ * @brief I/O request structure
+ *
+ * IoOperation_t operation: requested operation
+ * uint32_t address: device address (flash address, source address, ...)
+ * void * buffer: pointer to request's data
+ * uint32_t length: data length, in the device's units
+ * IoCallback_t callback: called when the request is complete, or NULL
+ * void * context: application's data, for the callback
+ * HAL_StatusTypeDef status: completion status, set by MiROS
+ * uint32_t pending: 1 while the request is queued, set by MiROS
+ * Semaphore_t done: signaled when the request is complete, managed by MiROS
+ * IoRequest_t * next: next request in device's queue, managed by MiROS
+ *
+ * > A request must not be modified, or go out of scope, while it's pending.
+ * */
+typedef struct IoRequest {
+  IoOperation_t operation;
+  uint32_t address;
+  void *buffer;
+  uint32_t length;
+  IoCallback_t callback;
+  void *context;
+  volatile HAL_StatusTypeDef status;
+  volatile uint32_t pending;
+  Semaphore_t done;
+  struct IoRequest *next;
+} IoRequest_t;
+
+/**
+ * @brief I/O device structure
+ *
+ * IoStart_t start: driver's start function
+ * IoIdle_t idle: driver's idle function, or NULL
+ * void * context: driver's data
+ * IoRequest_t * head: request in progress (head of the request queue)
+ * IoRequest_t * tail: last queued request
+ * uint32_t busy: 1 while the device has queued requests
+ * */
+typedef struct IoDevice {
+  IoStart_t start;
+  IoIdle_t idle;
+  void *context;
+  IoRequest_t *head;
+  IoRequest_t *tail;
+  uint32_t busy;
+} IoDevice_t;
+
+/**
+ * @brief Initialize an I/O device, called by device drivers
+ *
+ * @param [in] device pointer to the device structure
+ * @param [in] start driver's start function
+ * @param [in] idle driver's idle function, or NULL
+ * @param [in] context driver's data
+ *
+ * @return void
+ * */
+void MIROS_IoDeviceInitialize(IoDevice_t *device, IoStart_t start,
+    IoIdle_t idle, void *context);
+
+/**
+ * @brief Initialize an I/O request
+ *
+ * @param [in] request pointer to the request structure
+ * @param [in] operation requested operation
+ * @param [in] address device address
+ * @param [in] buffer pointer to request's data
+ * @param [in] length data length
+ *
+ * @return void
+ * */
+void MIROS_IoRequestInitialize(IoRequest_t *request, IoOperation_t operation,
+    uint32_t address, void *buffer, uint32_t length);
+
+/**
+ * @brief Queue a request, without blocking. The request is started right
+ * away if the device is idle, or as soon as the previous request completes,
+ * from the device's ISR. So several requests can be queued to keep the
+ * device busy back-to-back.
+ *
+ * When the request completes, its semaphore is signaled, for
+ * #MIROS_IoWait(), then its callback is called (if any). A callback may
+ * resubmit its request, to pipeline transfers. A request with a callback
+ * isn't waited for, as the woken task could reuse it before the callback
+ * runs.
+ *
+ * @param [in] device pointer to the device
+ * @param [in] request pointer to the request
+ * @param [in] callback completion callback, or NULL
+ * @param [in] context application's data, for the callback
+ *
+ * @return void
+ * */
+void MIROS_IoSubmit(IoDevice_t *device, IoRequest_t *request,
+    IoCallback_t callback, void *context);
+
+/**
+ * @brief Block the calling task until a submitted request completes
+ *
+ * @pre Called from a task's context, not from an ISR
+ * @pre @p request was submitted by #MIROS_IoSubmit(), and only one task
+ *    waits for it
+ *
+ * @param [in] request pointer to the request
+ *
+ * @return HAL_StatusTypeDef: request's completion status
+ * */
+HAL_StatusTypeDef MIROS_IoWait(IoRequest_t *request);
+
+/**
+ * @brief Submit a request, and block until it completes
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] device pointer to the device
+ * @param [in] request pointer to the request
+ *
+ * @return HAL_StatusTypeDef: request's completion status
+ * */
+HAL_StatusTypeDef MIROS_IoTransfer(IoDevice_t *device, IoRequest_t *request);
+
+/**
+ * @brief Complete the request in progress, called by device drivers
+ * (usually from the device's ISR). The next queued request is started
+ * before the completed request is signaled, to keep the device busy.
+ *
+ * @param [in] device pointer to the device
+ * @param [in] status request's completion status
+ *
+ * @return void
+ * */
+void MIROS_IoComplete(IoDevice_t *device, HAL_StatusTypeDef status);
+
+#endif /* _INC_MIROS_IO_H_ */
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * @file    miros_kvs.h
+ * @brief   MiROS wear-leveled key-value store on internal flash pages
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_KVS_H_
+#define _INC_MIROS_KVS_H_
+
+/**
+ * @brief Address of the first flash page used by the key-value store. Must
+ * be reserved in the linker script, so no code or data is placed there.
+ * */
+#ifndef MIROS_KVS_FIRST_PAGE
+#define MIROS_KVS_FIRST_PAGE        0x0801F000
+#endif
+
+/**
+ * @brief Number of flash pages used by the key-value store (at least 3)
+ * */
+#ifndef MIROS_KVS_NUM_PAGES
+#define MIROS_KVS_NUM_PAGES         4
+#endif
+
+/**
+ * @brief Number of erased pages the store keeps ready, background compaction
+ * is requested when fewer pages are erased.
+ * */
+#ifndef MIROS_KVS_SPARE_PAGES
+#define MIROS_KVS_SPARE_PAGES       2
+#endif
+
+/**
+ * @brief Number of keys, valid keys are in the range [1, MIROS_KVS_NUM_KEYS]
+ * (at most 254)
+ * */
+#ifndef MIROS_KVS_NUM_KEYS
+#define MIROS_KVS_NUM_KEYS          32
+#endif
+
+/**
+ * @brief Maximum size of a value in bytes (at most 255)
+ * */
+#ifndef MIROS_KVS_MAX_VALUE_SIZE
+#define MIROS_KVS_MAX_VALUE_SIZE    32
+#endif
+
+/**
+ * @brief Initialize the key-value store. Scans the store's pages to build
+ * the RAM index of the latest record of each key, and repairs the record
+ * that was being written when power was lost (if any).
+ *
+ * Records are appended to the pages as a log, each record is a header
+ * half-word (key, value size) followed by the value. The value is programmed
+ * first, and the header last, so a record is either committed or ignored
+ * after a power loss. Pages are erased in the background, by the
+ * compaction task #MIROS_KvsTask(), after their live records are copied to
+ * the head of the log.
+ *
+ * > The live records (latest value of each key) must fit in a single page.
+ *
+ * @pre #MIROS_FlashInitialize() was called
+ * @pre Called from a task's context, before any other key-value store
+ *    function
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_KvsInitialize(void);
+
+/**
+ * @brief Read the latest value of @p key
+ *
+ * @param [in] key key to read
+ * @param [out] value buffer to receive the value
+ * @param [in] size size of @p value buffer in bytes, if the value is larger,
+ *    only the first @p size bytes are copied
+ *
+ * @return uint32_t: size of the stored value in bytes, or 0 if @p key is
+ *    not found
+ * */
+uint32_t MIROS_KvsRead(uint32_t key, void *value, uint32_t size);
+
+/**
+ * @brief Write a new value of @p key, by appending a record to the log. The
+ * calling task is blocked only for the time it takes to program the record's
+ * half-words. Writing the same value as the stored one doesn't program
+ * anything.
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] key key to write
+ * @param [in] value pointer to the value
+ * @param [in] size size of the value in bytes, in the range
+ *    [1, MIROS_KVS_MAX_VALUE_SIZE]
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the record is committed, HAL_BUSY if
+ *    there's no erased page left (compaction is behind), HAL_ERROR if
+ *    programming failed
+ * */
+HAL_StatusTypeDef MIROS_KvsWrite(uint32_t key, const void *value,
+    uint32_t size);
+
+/**
+ * @brief Delete @p key, by appending an empty record to the log
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] key key to delete
+ *
+ * @return HAL_StatusTypeDef: same as #MIROS_KvsWrite()
+ * */
+HAL_StatusTypeDef MIROS_KvsDelete(uint32_t key);
+
+/**
+ * @brief Perform a single compaction step: erase a dirty page, or move the
+ * live records of the oldest page to the head of the log then erase it.
+ * Only done when fewer than #MIROS_KVS_SPARE_PAGES pages are erased.
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param void
+ *
+ * @return uint32_t: 1 if a page was erased, 0 if there was nothing to do
+ * */
+uint32_t MIROS_KvsCompact(void);
+
+/**
+ * @brief Key-value store compaction task handle. Blocks until compaction is
+ * requested by the store, then compacts until enough pages are erased.
+ * Should be added as the lowest priority (idle-like) task, as it only
+ * reclaims space ahead of time.
+ * */
+void MIROS_KvsTask(void);
+
+#endif /* _INC_MIROS_KVS_H_ */
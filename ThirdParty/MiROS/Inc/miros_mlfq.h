@@ -0,0 +1,106 @@
+/******************************************************************************
+ * @file    miros_mlfq.h
+ * @brief   Multilevel feedback queue scheduling
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_MLFQ_H_
+#define _INC_MIROS_MLFQ_H_
+
+/**
+ * Tasks attached to the multilevel feedback queue get their priorities from
+ * their behavior, instead of fixed priorities: they occupy a band of
+ * #MIROS_MLFQ_LEVELS priority levels, below the real-time priorities, and
+ * start at the top level. A task that uses its whole quantum at a level
+ * (a CPU bound task) sinks one level, and a task that blocks before using its
+ * quantum (an interactive task, like a console or a shell) rises one level.
+ * Lower levels have longer quanta. To prevent starvation, all the tasks are
+ * moved back to the top level every #MIROS_MLFQ_BOOST_PERIOD ticks.
+ *
+ * > Requires the priority scheduler (#MIROS_SCHED_PRIORITY).
+ * */
+
+/**
+ * @brief Number of levels
+ * */
+#ifndef MIROS_MLFQ_LEVELS
+#define MIROS_MLFQ_LEVELS           4
+#endif
+
+/**
+ * @brief Priority of the top level, the levels occupy the priorities from
+ * `MIROS_MLFQ_TOP_PRIORITY - MIROS_MLFQ_LEVELS + 1` to
+ * #MIROS_MLFQ_TOP_PRIORITY
+ * */
+#ifndef MIROS_MLFQ_TOP_PRIORITY
+#define MIROS_MLFQ_TOP_PRIORITY     5
+#endif
+
+/**
+ * @brief Quantum of each level in OS ticks, from the top level down
+ * */
+#ifndef MIROS_MLFQ_QUANTA
+#define MIROS_MLFQ_QUANTA           { 2, 4, 8, 16 }
+#endif
+
+/**
+ * @brief Aging period in OS ticks, all tasks are moved to the top level
+ * every period
+ * */
+#ifndef MIROS_MLFQ_BOOST_PERIOD
+#define MIROS_MLFQ_BOOST_PERIOD     1000
+#endif
+
+/**
+ * @brief Attach a task to the multilevel feedback queue, at its top level
+ *
+ * @pre @p task is initialized
+ *
+ * @param [in] task pointer to the task
+ *
+ * @return void
+ * */
+void MIROS_MlfqAttach(Task_t *task);
+
+/**
+ * @brief Account the running task's quantum, and age the tasks. Called by the
+ * kernel from #MIROS_Tick(), with interrupts disabled.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_MlfqTick(void);
+
+/**
+ * @brief Raise @p task one level, if it blocks before using its quantum.
+ * Called by the kernel from #MIROS_TaskBlock(), with interrupts disabled.
+ *
+ * @param [in] task pointer to the task that blocks
+ *
+ * @return void
+ * */
+void MIROS_MlfqBlock(Task_t *task);
+
+#endif /* _INC_MIROS_MLFQ_H_ */
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * @file    miros_mutex.h
+ * @brief   Priority ceiling mutexes (stack resource policy)
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_MUTEX_H_
+#define _INC_MIROS_MUTEX_H_
+
+/**
+ * Mutexes use the immediate priority ceiling protocol, in its stack resource
+ * policy (SRP) form: each mutex is given a ceiling, the highest priority of
+ * the tasks that lock it. Locking a mutex raises the system ceiling to the
+ * mutex's ceiling at once, so no other task that uses the mutex can preempt
+ * the owner until it's unlocked.
+ *
+ * As a result, locking never blocks: when a task starts running, all the
+ * mutexes it can lock are free. A task is blocked at most once, before it
+ * starts, for the duration of the longest critical section of a lower
+ * priority task, there are no chained blockings nor deadlocks. And the
+ * blocking happens before the task starts, which allows run-to-completion
+ * tasks to share a single stack.
+ *
+ * A mutex shared with ISRs is given an interrupt ceiling
+ * (#MIROS_MUTEX_IRQ_CEILING()). Locking it masks the interrupts up to that
+ * NVIC priority using BASEPRI (and all task switches, as PendSV has the
+ * lowest priority), and ISRs access the shared resource without locking.
+ *
+ * > Requires the priority scheduler (#MIROS_SCHED_PRIORITY).
+ *
+ * > Mutexes must be unlocked in the reverse order of locking, and the owner
+ * > must not block (wait on a semaphore, delay, ...) while holding a mutex.
+ * */
+
+/**
+ * @brief Ceiling of a mutex that is shared with ISRs of NVIC priority
+ * @p irq_priority and below. @p irq_priority can't be 0, as BASEPRI can't
+ * mask priority 0 interrupts.
+ * */
+#define MIROS_MUTEX_IRQ_CEILING(irq_priority)   \
+  (MIROS_NUM_PRIORITIES + (irq_priority))
+
+/**
+ * @brief Mutex structure
+ *
+ * uint32_t ceiling: mutex's ceiling, the highest priority of the tasks that
+ *    lock the mutex, or an interrupt ceiling
+ * Task_t * owner: task that locked the mutex, NULL if it's not locked
+ * uint32_t saved_ceiling: system ceiling before the mutex was locked
+ * Task_t * saved_owner: system ceiling's owner before the mutex was locked
+ * uint32_t saved_basepri: BASEPRI before the mutex was locked
+ * struct Mutex * previous: mutex locked before this one (mutexes are locked
+ *    and unlocked in a stack order)
+ * */
+typedef struct Mutex {
+  uint32_t ceiling;
+  Task_t *owner;
+  uint32_t saved_ceiling;
+  Task_t *saved_owner;
+  uint32_t saved_basepri;
+  struct Mutex *previous;
+} Mutex_t;
+
+/**
+ * @brief Initialize a mutex
+ *
+ * @param [in] mutex pointer to the mutex structure
+ * @param [in] ceiling mutex's ceiling, the highest priority of the tasks
+ *    that lock it, or #MIROS_MUTEX_IRQ_CEILING()
+ *
+ * @return void
+ * */
+void MIROS_MutexInitialize(Mutex_t *mutex, uint32_t ceiling);
+
+/**
+ * @brief Lock a mutex, raises the system ceiling to the mutex's ceiling.
+ * Never blocks.
+ *
+ * @pre Called from a task's context, not from an ISR
+ * @pre The running task's priority is less than or equal to mutex's ceiling
+ *
+ * @param [in] mutex pointer to the mutex
+ *
+ * @return void
+ * */
+void MIROS_MutexLock(Mutex_t *mutex);
+
+/**
+ * @brief Unlock a mutex, restores the system ceiling, and switches to a
+ * higher priority task that was kept out by the ceiling, if any.
+ *
+ * @pre @p mutex is the last mutex locked by the running task
+ *
+ * @param [in] mutex pointer to the mutex
+ *
+ * @return void
+ * */
+void MIROS_MutexUnlock(Mutex_t *mutex);
+
+/**
+ * @brief Check whether a task holds a mutex. Called by the kernel, with
+ * interrupts disabled, to defer suspending a task that exhausted its budget
+ * until it unlocks its mutexes.
+ *
+ * @param [in] task pointer to the task
+ *
+ * @return uint32_t: 1 if @p task holds a mutex, 0 otherwise
+ * */
+uint32_t MIROS_MutexHeld(const Task_t *task);
+
+#endif /* _INC_MIROS_MUTEX_H_ */
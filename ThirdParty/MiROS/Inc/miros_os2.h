@@ -0,0 +1,335 @@
+/******************************************************************************
+ * @file    miros_os2.h
+ * @brief   MiROS CMSIS-RTOS2 layer, control blocks and configuration
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_OS2_H_
+#define _INC_MIROS_OS2_H_
+
+/**
+ * Control blocks of CMSIS-RTOS2 objects (cmsis_os2.h). The application
+ * either allocates them statically, and passes them in the objects'
+ * attributes:
+ *
+ * static Os2Semaphore_t SemCb;
+ * static const osSemaphoreAttr_t SemAttr = {
+ *   .name = "sem", .cb_mem = &SemCb, .cb_size = sizeof(SemCb)
+ * };
+ * osSemaphoreId_t sem = osSemaphoreNew(4, 0, &SemAttr);
+ *
+ * or passes NULL attributes (or NULL `cb_mem`, `stack_mem`, `mp_mem`,
+ * `mq_mem`), and they're taken from static pools, sized by
+ * #MIROS_OS2_MAX_THREADS, #MIROS_OS2_MAX_SEMAPHORES, ... Deleted objects'
+ * control blocks go back to their pool. Threads never end, so their control
+ * blocks and stacks aren't reclaimed, nor are pools' and queues' storage,
+ * reserved from #MIROS_OS2_ARENA_SIZE bytes.
+ *
+ * Timeouts other than 0 and osWaitForever are waited for by polling, once
+ * every tick, as MiROS blocking waits don't time out.
+ *
+ * Mutexes block on a semaphore, like the POSIX layer's: the owner may block
+ * while holding a mutex, they may be released in any order, and may be
+ * recursive (osMutexRecursive). They don't inherit priorities.
+ *
+ * Message queues are FIFO, message priorities are ignored.
+ *
+ * > Requires cmsis_os2.h and miros_sem.h to be included first
+ * */
+
+/**
+ * @brief Idle task's stack size (in words), the idle task is created by
+ * osKernelInitialize()
+ * */
+#ifndef MIROS_OS2_IDLE_STACK_SIZE
+#define MIROS_OS2_IDLE_STACK_SIZE   64
+#endif
+
+/**
+ * @brief Timer task's stack size (in words), timers' callbacks run in the
+ * timer task
+ * */
+#ifndef MIROS_OS2_TIMER_STACK_SIZE
+#define MIROS_OS2_TIMER_STACK_SIZE  128
+#endif
+
+/**
+ * @brief Timer task's (MiROS) priority
+ * */
+#ifndef MIROS_OS2_TIMER_PRIORITY
+#define MIROS_OS2_TIMER_PRIORITY    (MIROS_NUM_PRIORITIES - 1)
+#endif
+
+/**
+ * @brief Number of threads created without a control block or a stack
+ * (taken from static pools)
+ * */
+#ifndef MIROS_OS2_MAX_THREADS
+#define MIROS_OS2_MAX_THREADS       4
+#endif
+
+/**
+ * @brief Stack size (in words) of threads created without a stack, the
+ * largest `stack_size` (in bytes) such threads may ask for
+ * */
+#ifndef MIROS_OS2_THREAD_STACK_SIZE
+#define MIROS_OS2_THREAD_STACK_SIZE 128
+#endif
+
+/**
+ * @brief Number of timers created without a control block
+ * */
+#ifndef MIROS_OS2_MAX_TIMERS
+#define MIROS_OS2_MAX_TIMERS        4
+#endif
+
+/**
+ * @brief Number of event flags created without a control block
+ * */
+#ifndef MIROS_OS2_MAX_EVENT_FLAGS
+#define MIROS_OS2_MAX_EVENT_FLAGS   4
+#endif
+
+/**
+ * @brief Number of mutexes created without a control block
+ * */
+#ifndef MIROS_OS2_MAX_MUTEXES
+#define MIROS_OS2_MAX_MUTEXES       4
+#endif
+
+/**
+ * @brief Number of semaphores created without a control block
+ * */
+#ifndef MIROS_OS2_MAX_SEMAPHORES
+#define MIROS_OS2_MAX_SEMAPHORES    4
+#endif
+
+/**
+ * @brief Number of memory pools created without a control block
+ * */
+#ifndef MIROS_OS2_MAX_MEMORY_POOLS
+#define MIROS_OS2_MAX_MEMORY_POOLS  2
+#endif
+
+/**
+ * @brief Number of message queues created without a control block
+ * */
+#ifndef MIROS_OS2_MAX_MESSAGE_QUEUES
+#define MIROS_OS2_MAX_MESSAGE_QUEUES  2
+#endif
+
+/**
+ * @brief Size (in bytes) of the static arena that memory pools' and
+ * message queues' storage is reserved from, when it's not given
+ * */
+#ifndef MIROS_OS2_ARENA_SIZE
+#define MIROS_OS2_ARENA_SIZE        1024
+#endif
+
+/**
+ * @brief Map a CMSIS-RTOS2 priority (osPriorityIdle ... osPriorityISR - 1)
+ * onto a MiROS priority (0 ... #MIROS_NUM_PRIORITIES - 1)
+ * */
+#define MIROS_OS2_PRIORITY(priority)    \
+  ((((uint32_t) (priority) - 1U) * MIROS_NUM_PRIORITIES)  \
+      / ((uint32_t) osPriorityISR - 1U))
+
+/**
+ * @brief Size of a memory pool's storage (mp_mem), blocks are word aligned
+ * */
+#define MIROS_OS2_MP_SIZE(block_count, block_size)  \
+  ((block_count) * (((block_size) + 3U) & ~3U))
+
+/**
+ * @brief Size of a message queue's storage (mq_mem)
+ * */
+#define MIROS_OS2_MQ_SIZE(msg_count, msg_size)  \
+  ((msg_count) * (msg_size))
+
+/**
+ * @brief Thread control block
+ *
+ * Task_t task: MiROS task, runs the thread's function with its argument
+ * osThreadFunc_t func: thread's function
+ * void * argument: thread function's argument
+ * const char * name: thread's name
+ * osPriority_t priority: thread's CMSIS-RTOS2 priority
+ * */
+typedef struct {
+  Task_t task;
+  osThreadFunc_t func;
+  void *argument;
+  const char *name;
+  osPriority_t priority;
+} Os2Thread_t;
+
+/**
+ * @brief Timer control block
+ *
+ * struct Os2Timer * next: next started timer
+ * osTimerFunc_t func: timer's callback
+ * void * argument: callback's argument
+ * const char * name: timer's name
+ * osTimerType_t type: one shot or periodic
+ * uint32_t period: timer's period, in ticks
+ * uint32_t remaining: ticks until the timer expires
+ * uint8_t running: timer was started, and not stopped (or expired)
+ * uint8_t pending: timer expired, its callback wasn't called yet
+ * uint8_t linked: timer is in the started timers list
+ * */
+typedef struct Os2Timer {
+  struct Os2Timer *next;
+  osTimerFunc_t func;
+  void *argument;
+  const char *name;
+  osTimerType_t type;
+  uint32_t period;
+  uint32_t remaining;
+  uint8_t running;
+  uint8_t pending;
+  uint8_t linked;
+} Os2Timer_t;
+
+/**
+ * @brief Event flags control block
+ *
+ * Semaphore_t changed: posted once for every blocked waiter when flags are
+ *    set, waiters check their flags again
+ * uint32_t flags: current flags
+ * uint32_t waiters: number of waiters blocked on changed
+ * const char * name: event flags' name
+ * */
+typedef struct {
+  Semaphore_t changed;
+  uint32_t flags;
+  uint32_t waiters;
+  const char *name;
+} Os2EventFlags_t;
+
+/**
+ * @brief Mutex control block
+ *
+ * Semaphore_t lock: 1 token while the mutex is free
+ * Task_t * owner: thread that acquired the mutex, NULL if it's free
+ * uint32_t count: number of times the owner acquired the mutex
+ * uint32_t attr_bits: mutex's attributes (osMutexRecursive)
+ * const char * name: mutex's name
+ * */
+typedef struct {
+  Semaphore_t lock;
+  Task_t *owner;
+  uint32_t count;
+  uint32_t attr_bits;
+  const char *name;
+} Os2Mutex_t;
+
+/**
+ * @brief Semaphore control block
+ *
+ * Semaphore_t sem: MiROS semaphore
+ * uint32_t max_count: maximum number of tokens
+ * const char * name: semaphore's name
+ * */
+typedef struct {
+  Semaphore_t sem;
+  uint32_t max_count;
+  const char *name;
+} Os2Semaphore_t;
+
+/**
+ * @brief Memory pool control block
+ *
+ * Semaphore_t free: number of free blocks
+ * void * free_list: list of free blocks, linked through the blocks' first
+ *    word
+ * uint8_t * mem: pool's storage (mp_mem)
+ * uint32_t block_size: block size, word aligned
+ * uint32_t block_count: number of blocks
+ * const char * name: memory pool's name
+ * */
+typedef struct {
+  Semaphore_t free;
+  void *free_list;
+  uint8_t *mem;
+  uint32_t block_size;
+  uint32_t block_count;
+  const char *name;
+} Os2MemoryPool_t;
+
+/**
+ * @brief Message queue control block
+ *
+ * Semaphore_t slots: number of free message slots
+ * Semaphore_t messages: number of queued messages
+ * uint8_t * buffer: queue's storage (mq_mem)
+ * uint32_t msg_size: message size
+ * uint32_t msg_count: maximum number of messages
+ * uint32_t head: index of the oldest message
+ * uint32_t tail: index of the next free slot
+ * const char * name: message queue's name
+ * */
+typedef struct {
+  Semaphore_t slots;
+  Semaphore_t messages;
+  uint8_t *buffer;
+  uint32_t msg_size;
+  uint32_t msg_count;
+  uint32_t head;
+  uint32_t tail;
+  const char *name;
+} Os2MessageQueue_t;
+
+/**
+ * @brief CMSIS-RTOS2 layer's overhead, in CPU cycles, of a non-blocking
+ * round trip (take, then give back) through each object type, and of the
+ * same round trip through the native MiROS calls, where there's one: a
+ * semaphore post and take, and an SRP mutex lock and unlock (0 under the
+ * round robin scheduler). Event flags, memory pools and message queues have
+ * no native counterpart, only their round trip is measured.
+ *
+ * > No numbers are recorded in the tree, they're only known once
+ * > MIROS_Os2Measure() runs on the target.
+ * */
+typedef struct {
+  uint32_t sem_native;
+  uint32_t sem_os2;
+  uint32_t mutex_native;
+  uint32_t mutex_os2;
+  uint32_t flags_os2;
+  uint32_t pool_os2;
+  uint32_t queue_os2;
+} Os2Overhead_t;
+
+/**
+ * @brief Measure the CMSIS-RTOS2 layer's overhead, using DWT cycle counter
+ *
+ * @pre Called from a privileged thread, after osKernelStart()
+ *
+ * @param [out] overhead measured cycles
+ *
+ * @return void
+ * */
+void MIROS_Os2Measure(Os2Overhead_t *overhead);
+
+#endif /* _INC_MIROS_OS2_H_ */
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * @file    miros_partition.h
+ * @brief   Time partitions (ARINC 653 style)
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_PARTITION_H_
+#define _INC_MIROS_PARTITION_H_
+
+/**
+ * Tasks are grouped into partitions, and a major frame is split into time
+ * windows, each window given to one partition. During a window, only the
+ * window's partition's tasks are scheduled (by the partition's local policy),
+ * so each partition gets its CPU share regardless of what the other
+ * partitions do. Windows are enforced by the OS tick, and the major frame is
+ * repeated forever.
+ *
+ * Tasks that are not added to any partition (kernel service tasks, like the
+ * trace log or key-value store tasks) are only scheduled in spare windows
+ * (windows without a partition), by their priorities, so they can't take a
+ * partition's time. The idle task runs whenever no eligible task is ready.
+ *
+ * > Requires the priority scheduler (#MIROS_SCHED_PRIORITY).
+ * */
+
+/**
+ * @brief Partitions' local scheduling policies
+ *
+ * MIROS_PARTITION_ROUND_ROBIN: partition's tasks are executed in turns, they
+ *    are all given #MIROS_PARTITION_RR_PRIORITY while in the partition
+ * MIROS_PARTITION_PRIORITY: partition's tasks are scheduled by their
+ *    priorities
+ * */
+#define MIROS_PARTITION_ROUND_ROBIN     0
+#define MIROS_PARTITION_PRIORITY        1
+
+/**
+ * @brief Priority of round robin partitions' tasks, a level of its own, above
+ * the proportional share level (#MIROS_FAIR_PRIORITY)
+ * */
+#ifndef MIROS_PARTITION_RR_PRIORITY
+#define MIROS_PARTITION_RR_PRIORITY     (MIROS_FAIR_PRIORITY + 1)
+#endif
+
+/**
+ * @brief Partition structure
+ *
+ * uint32_t policy: partition's local scheduling policy
+ * uint32_t tasks: ids of the partition's tasks (bit n is the task of id n)
+ * */
+typedef struct {
+  uint32_t policy;
+  uint32_t tasks;
+} Partition_t;
+
+/**
+ * @brief Major frame window
+ *
+ * Partition_t * partition: partition that runs in the window, or NULL for a
+ *    spare window (only tasks that are not in any partition run)
+ * uint32_t duration: window's duration, in OS ticks (more than 0)
+ * */
+typedef struct {
+  Partition_t *partition;
+  uint32_t duration;
+} PartitionWindow_t;
+
+/**
+ * @brief Major frame, a sequence of windows
+ *
+ * const PartitionWindow_t * windows: frame's windows, in order
+ * uint32_t num_windows: number of windows
+ * */
+typedef struct {
+  const PartitionWindow_t *windows;
+  uint32_t num_windows;
+} PartitionSchedule_t;
+
+/**
+ * @brief Initialize a partition
+ *
+ * @param [in] partition pointer to the partition structure
+ * @param [in] policy partition's local scheduling policy
+ *
+ * @return void
+ * */
+void MIROS_PartitionInitialize(Partition_t *partition, uint32_t policy);
+
+/**
+ * @brief Add a task to a partition. A round robin partition's task is given
+ * #MIROS_PARTITION_RR_PRIORITY, its priority is restored when it's removed.
+ *
+ * @pre @p task is initialized, and isn't in any partition
+ *
+ * @param [in] partition pointer to the partition
+ * @param [in] task pointer to the task
+ *
+ * @return void
+ * */
+void MIROS_PartitionAddTask(Partition_t *partition, Task_t *task);
+
+/**
+ * @brief Remove a task from its partition, restoring the priority it had
+ * before it was added. The task is then only scheduled in spare windows.
+ *
+ * @pre @p task is in @p partition
+ *
+ * @param [in] partition pointer to the partition
+ * @param [in] task pointer to the task
+ *
+ * @return void
+ * */
+void MIROS_PartitionRemoveTask(Partition_t *partition, Task_t *task);
+
+/**
+ * @brief Start running the major frame, from its first window
+ *
+ * @param [in] schedule pointer to the major frame
+ *
+ * @return void
+ * */
+void MIROS_PartitionStart(const PartitionSchedule_t *schedule);
+
+/**
+ * @brief Switch partitions at the end of each window. Called by the kernel
+ * from #MIROS_Tick(), with interrupts disabled.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_PartitionTick(void);
+
+/**
+ * @brief Get the partition switch overhead (switching the scheduler to the
+ * next partition's tasks), measured in CPU cycles using DWT cycle counter
+ *
+ * @param [out] max longest measured switch, can be NULL
+ *
+ * @return uint32_t: last measured switch
+ * */
+uint32_t MIROS_PartitionSwitchCycles(uint32_t *max);
+
+#endif /* _INC_MIROS_PARTITION_H_ */
@@ -0,0 +1,326 @@
+/******************************************************************************
+ * @file    miros_posix.h
+ * @brief   POSIX threads, semaphores, clocks and message queues on MiROS
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_POSIX_H_
+#define _INC_MIROS_POSIX_H_
+
+/**
+ * A subset of POSIX (pthreads, semaphores, clocks and message queues)
+ * implemented over MiROS tasks and semaphores (miros_posix.c), so libraries
+ * written against POSIX compile unchanged for the MCU and for the host.
+ * They include the standard headers (<pthread.h>, <semaphore.h>,
+ * <mqueue.h>) found in `ThirdParty/MiROS/Inc/posix`, which must be on the
+ * include path ahead of the toolchain's headers.
+ *
+ * Nothing is allocated on the hot calls (lock, wait, post, send, receive,
+ * ...): threads' control blocks are kept at the top of their stacks, given
+ * with pthread_attr_setstack() or taken from a static pool of
+ * #MIROS_POSIX_THREADS stacks, and message queues' storage is reserved from
+ * a static arena at mq_open().
+ *
+ * Limitations:
+ * - MiROS tasks can't be deleted, a thread's task (and stack) stays blocked
+ *    after pthread_exit()
+ * - Pooled stacks aren't reclaimed, even after pthread_join(), at most
+ *    #MIROS_POSIX_THREADS threads are created without a stack over the
+ *    application's lifetime
+ * - Thread priorities (`sched_priority`) are MiROS priorities, threads
+ *    inherit their creator's priority by default
+ * - Mutexes block on a semaphore (they may be held while blocking, unlike
+ *    MiROS SRP mutexes), and don't inherit priorities
+ * - Timed waits are polled once every tick, as MiROS waits don't time out
+ * - All clocks are the HAL tick (1 ms resolution), there's no wall clock
+ * - A message queue's storage isn't reclaimed when it's unlinked
+ * */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/types.h>
+
+/*
+ * <sys/types.h> may declare libc's own pthread types (glibc always, newlib
+ * with _POSIX_THREADS), so MiROS's types have their own names, and the
+ * POSIX names are mapped to them. <sys/types.h> is included first, so its
+ * include guard keeps it from being expanded again after the mapping.
+ * */
+#define pthread_t                   PosixThreadId_t
+#define pthread_attr_t              PosixThreadAttr_t
+#define pthread_mutexattr_t         PosixMutexAttr_t
+#define pthread_mutex_t             PosixMutex_t
+#define pthread_condattr_t          PosixCondAttr_t
+#define pthread_cond_t              PosixCond_t
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+
+/**
+ * @brief Number of stacks in the static stack pool, used by threads created
+ * without a stack (pthread_attr_setstack())
+ * */
+#ifndef MIROS_POSIX_THREADS
+#define MIROS_POSIX_THREADS         4
+#endif
+
+/**
+ * @brief Size of stack pool's stacks, in words
+ * */
+#ifndef MIROS_POSIX_THREAD_STACK_SIZE
+#define MIROS_POSIX_THREAD_STACK_SIZE   256
+#endif
+
+/**
+ * @brief Maximum number of message queues, and of open message queue
+ * descriptors
+ * */
+#ifndef MIROS_POSIX_MQ_MAX
+#define MIROS_POSIX_MQ_MAX          4
+#endif
+
+#ifndef MIROS_POSIX_MQ_OPEN_MAX
+#define MIROS_POSIX_MQ_OPEN_MAX     8
+#endif
+
+/**
+ * @brief Size of message queues' storage arena, in bytes
+ * */
+#ifndef MIROS_POSIX_MQ_ARENA_SIZE
+#define MIROS_POSIX_MQ_ARENA_SIZE   1024
+#endif
+
+/**
+ * @brief Message queue's name length (including the terminating null), and
+ * default attributes (queues created without attributes)
+ * */
+#ifndef MIROS_POSIX_MQ_NAME_MAX
+#define MIROS_POSIX_MQ_NAME_MAX     16
+#endif
+
+#ifndef MIROS_POSIX_MQ_MAXMSG
+#define MIROS_POSIX_MQ_MAXMSG       8
+#endif
+
+#ifndef MIROS_POSIX_MQ_MSGSIZE
+#define MIROS_POSIX_MQ_MSGSIZE      32
+#endif
+
+#ifndef PTHREAD_STACK_MIN
+#define PTHREAD_STACK_MIN           256
+#endif
+
+#ifndef SEM_VALUE_MAX
+#define SEM_VALUE_MAX               0x7FFFFFFF
+#endif
+
+#ifndef MQ_PRIO_MAX
+#define MQ_PRIO_MAX                 32
+#endif
+
+#ifndef CLOCK_REALTIME
+#define CLOCK_REALTIME              ((clockid_t) 1)
+#endif
+
+#ifndef CLOCK_MONOTONIC
+#define CLOCK_MONOTONIC             ((clockid_t) 4)
+#endif
+
+#ifndef TIMER_ABSTIME
+#define TIMER_ABSTIME               4
+#endif
+
+#define PTHREAD_CREATE_JOINABLE     0
+#define PTHREAD_CREATE_DETACHED     1
+
+#define PTHREAD_MUTEX_NORMAL        0
+#define PTHREAD_MUTEX_RECURSIVE     1
+#define PTHREAD_MUTEX_ERRORCHECK    2
+#define PTHREAD_MUTEX_DEFAULT       PTHREAD_MUTEX_NORMAL
+
+/**
+ * @brief Thread control block, at the top of the thread's stack
+ *
+ * Task_t task: MiROS task, runs the thread's start routine
+ * void *(*start_routine)(void*): thread's start routine
+ * void * arg: start routine's argument
+ * void * retval: thread's exit status
+ * Semaphore_t done: posted when a joinable thread exits
+ * int detached: thread is detached (or was joined)
+ * */
+typedef struct {
+  Task_t task;
+  void *(*start_routine)(void*);
+  void *arg;
+  void *retval;
+  Semaphore_t done;
+  int detached;
+} PosixThread_t;
+
+typedef PosixThread_t *PosixThreadId_t;
+
+/**
+ * @brief Thread attributes, a priority (`sched_priority`) of -1 inherits the
+ * creator's priority
+ * */
+typedef struct {
+  void *stackaddr;
+  size_t stacksize;
+  int detachstate;
+  struct sched_param param;
+} PosixThreadAttr_t;
+
+typedef struct {
+  int type;
+} PosixMutexAttr_t;
+
+/**
+ * @brief Mutex, a binary semaphore and its owner
+ * */
+typedef struct {
+  Semaphore_t lock;
+  Task_t *owner;
+  int type;
+  uint32_t count;
+} PosixMutex_t;
+
+#define PTHREAD_MUTEX_INITIALIZER   \
+  { { 1, NULL, NULL }, NULL, PTHREAD_MUTEX_DEFAULT, 0 }
+
+typedef struct {
+  int unused;
+} PosixCondAttr_t;
+
+/**
+ * @brief Condition variable, a semaphore signaled once per woken waiter
+ * */
+typedef struct {
+  Semaphore_t wait;
+  uint32_t waiters;
+} PosixCond_t;
+
+#define PTHREAD_COND_INITIALIZER    { { 0, NULL, NULL }, 0 }
+
+typedef struct {
+  Semaphore_t sem;
+} sem_t;
+
+/**
+ * @brief Message queue descriptor, index of an open descriptor
+ * */
+typedef int mqd_t;
+
+struct mq_attr {
+  long mq_flags;
+  long mq_maxmsg;
+  long mq_msgsize;
+  long mq_curmsgs;
+};
+
+/*  Threads  */
+int pthread_attr_init(pthread_attr_t *attr);
+int pthread_attr_destroy(pthread_attr_t *attr);
+int pthread_attr_setstack(pthread_attr_t *attr, void *stackaddr,
+    size_t stacksize);
+int pthread_attr_setdetachstate(pthread_attr_t *attr, int detachstate);
+int pthread_attr_setschedparam(pthread_attr_t *attr,
+    const struct sched_param *param);
+/**
+ * @brief Create a thread, running @p start_routine with @p arg
+ *
+ * A thread without a stack (pthread_attr_setstack()) takes one from the
+ * static pool, which isn't refilled when threads exit or are joined.
+ *
+ * @return int: 0, EINVAL if @p thread or @p start_routine is NULL, or the
+ *    priority is out of range, or EAGAIN if the stack pool
+ *    (#MIROS_POSIX_THREADS stacks, for the application's lifetime) is
+ *    exhausted or the kernel can't take the task (its task table is full,
+ *    or the admission control rejected it)
+ * */
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+    void *(*start_routine)(void*), void *arg);
+int pthread_join(pthread_t thread, void **retval);
+int pthread_detach(pthread_t thread);
+void pthread_exit(void *retval) __attribute__((noreturn));
+pthread_t pthread_self(void);
+int pthread_equal(pthread_t t1, pthread_t t2);
+int sched_yield(void);
+
+/*  Mutexes  */
+int pthread_mutexattr_init(pthread_mutexattr_t *attr);
+int pthread_mutexattr_destroy(pthread_mutexattr_t *attr);
+int pthread_mutexattr_settype(pthread_mutexattr_t *attr, int type);
+int pthread_mutex_init(pthread_mutex_t *mutex,
+    const pthread_mutexattr_t *attr);
+int pthread_mutex_destroy(pthread_mutex_t *mutex);
+int pthread_mutex_lock(pthread_mutex_t *mutex);
+int pthread_mutex_trylock(pthread_mutex_t *mutex);
+int pthread_mutex_unlock(pthread_mutex_t *mutex);
+
+/*  Condition variables  */
+int pthread_condattr_init(pthread_condattr_t *attr);
+int pthread_condattr_destroy(pthread_condattr_t *attr);
+int pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr);
+int pthread_cond_destroy(pthread_cond_t *cond);
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
+int pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex,
+    const struct timespec *abstime);
+int pthread_cond_signal(pthread_cond_t *cond);
+int pthread_cond_broadcast(pthread_cond_t *cond);
+
+/*  Semaphores  */
+int sem_init(sem_t *sem, int pshared, unsigned int value);
+int sem_destroy(sem_t *sem);
+int sem_wait(sem_t *sem);
+int sem_trywait(sem_t *sem);
+int sem_timedwait(sem_t *sem, const struct timespec *abstime);
+int sem_post(sem_t *sem);
+int sem_getvalue(sem_t *sem, int *value);
+
+/*  Clocks  */
+int clock_gettime(clockid_t clock_id, struct timespec *tp);
+int clock_nanosleep(clockid_t clock_id, int flags,
+    const struct timespec *request, struct timespec *remain);
+int nanosleep(const struct timespec *request, struct timespec *remain);
+
+/*  Message queues  */
+mqd_t mq_open(const char *name, int oflag, ...);
+int mq_close(mqd_t mqdes);
+int mq_unlink(const char *name);
+int mq_send(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
+    unsigned int msg_prio);
+int mq_timedsend(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
+    unsigned int msg_prio, const struct timespec *abstime);
+ssize_t mq_receive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
+    unsigned int *msg_prio);
+ssize_t mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
+    unsigned int *msg_prio, const struct timespec *abstime);
+int mq_getattr(mqd_t mqdes, struct mq_attr *attr);
+
+#endif /* _INC_MIROS_POSIX_H_ */
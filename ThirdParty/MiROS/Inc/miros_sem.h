@@ -0,0 +1,93 @@
+/******************************************************************************
+ * @file    miros_sem.h
+ * @brief   MiROS counting semaphore
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_SEM_H_
+#define _INC_MIROS_SEM_H_
+
+/**
+ * @brief Counting semaphore structure
+ *
+ * uint32_t count: number of available tokens
+ * Task_t * head: first task in the semaphore's wait queue (FIFO)
+ * Task_t * tail: last task in the semaphore's wait queue
+ *
+ * > Like tasks, semaphores must be allocated either statically, or
+ * > dynamically, but never locally, unless the owning task is guaranteed to
+ * > outlive all users of the semaphore.
+ * */
+typedef struct {
+  uint32_t count;
+  Task_t *head;
+  Task_t *tail;
+} Semaphore_t;
+
+/**
+ * @brief Initialize a semaphore
+ *
+ * @param [in] sem pointer to the semaphore structure
+ * @param [in] count initial number of available tokens
+ *
+ * @return void
+ * */
+void MIROS_SemInitialize(Semaphore_t *sem, uint32_t count);
+
+/**
+ * @brief Take a token from the semaphore, blocks the running task until a
+ * token is available.
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param [in] sem pointer to the semaphore
+ *
+ * @return void
+ * */
+void MIROS_SemWait(Semaphore_t *sem);
+
+/**
+ * @brief Take a token from the semaphore, if one is available, without
+ * blocking.
+ *
+ * @param [in] sem pointer to the semaphore
+ *
+ * @return uint32_t: 1 if a token was taken, 0 otherwise
+ * */
+uint32_t MIROS_SemTryWait(Semaphore_t *sem);
+
+/**
+ * @brief Give a token to the semaphore. If tasks are waiting on the
+ * semaphore, the token is handed to the first waiting task, which is
+ * unblocked.
+ *
+ * Can be called from both task and interrupt contexts.
+ *
+ * @param [in] sem pointer to the semaphore
+ *
+ * @return void
+ * */
+void MIROS_SemPost(Semaphore_t *sem);
+
+#endif /* _INC_MIROS_SEM_H_ */
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * @file    miros_server.h
+ * @brief   Sporadic servers for aperiodic tasks
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_SERVER_H_
+#define _INC_MIROS_SERVER_H_
+
+/**
+ * A sporadic server runs aperiodic tasks (command parsing, diagnostics, ...)
+ * at the server's priority, within the server's budget (capacity, in
+ * microseconds) per period. Every chunk of budget that is used is given
+ * back one period later, so the server never uses more than its capacity in
+ * any window of one period, and it interferes with lower priority periodic
+ * tasks no more than a periodic task of the same period and WCET. Which
+ * lets the periodic tasks keep their guarantees, while aperiodic work is
+ * served as soon as it arrives, as long as there's budget left.
+ *
+ * When the budget is exhausted, the server's tasks are demoted to
+ * #MIROS_SERVER_BACKGROUND_PRIORITY (where they aren't charged), until the
+ * budget is replenished.
+ *
+ * > Fixed priority counterpart of the constant bandwidth server (which
+ * > requires an EDF scheduler).
+ * */
+
+/**
+ * @brief Maximum number of tasks attached to a server
+ * */
+#ifndef MIROS_SERVER_MAX_TASKS
+#define MIROS_SERVER_MAX_TASKS          4
+#endif
+
+/**
+ * @brief Maximum number of pending budget replenishments per server, more
+ * replenishments are merged into the last one (delaying them)
+ * */
+#ifndef MIROS_SERVER_REPLENISHMENTS
+#define MIROS_SERVER_REPLENISHMENTS     8
+#endif
+
+/**
+ * @brief Priority of servers' tasks when their server's budget is exhausted
+ * */
+#ifndef MIROS_SERVER_BACKGROUND_PRIORITY
+#define MIROS_SERVER_BACKGROUND_PRIORITY    0
+#endif
+
+/**
+ * @brief Pending budget replenishment
+ *
+ * uint32_t tick: server tick at which the budget is replenished
+ * uint32_t amount: CPU cycles given back to the server's budget
+ * */
+typedef struct {
+  uint32_t tick;
+  uint32_t amount;
+} ServerReplenishment_t;
+
+/**
+ * @brief Sporadic server structure
+ *
+ * uint32_t priority: priority of the server's tasks while it has budget
+ * uint32_t capacity_us: server's budget per period, in microseconds
+ * uint32_t capacity: server's budget per period, in CPU cycles, converted
+ *    from capacity_us by #MIROS_ServerStart()
+ * uint32_t period: server's replenishment period, in OS ticks
+ * uint32_t budget: CPU cycles left in the server's budget
+ * ServerReplenishment_t replenishments[]: pending replenishments (FIFO)
+ * uint32_t head: first pending replenishment
+ * uint32_t count: number of pending replenishments
+ * Task_t * tasks[]: tasks attached to the server
+ * uint32_t num_tasks: number of attached tasks
+ * struct Server * next: next initialized server
+ * */
+typedef struct Server {
+  uint32_t priority;
+  uint32_t capacity_us;
+  uint32_t capacity;
+  uint32_t period;
+  uint32_t budget;
+  ServerReplenishment_t replenishments[MIROS_SERVER_REPLENISHMENTS];
+  uint32_t head;
+  uint32_t count;
+  Task_t *tasks[MIROS_SERVER_MAX_TASKS];
+  uint32_t num_tasks;
+  struct Server *next;
+} Server_t;
+
+/**
+ * @brief Initialize a sporadic server
+ *
+ * @pre Called before the scheduler is started
+ *
+ * @param [in] server pointer to the server structure
+ * @param [in] priority priority of the server's tasks
+ * @param [in] capacity server's budget per period, in microseconds
+ * @param [in] period server's period, in OS ticks
+ *
+ * @return void
+ * */
+void MIROS_ServerInitialize(Server_t *server, uint32_t priority,
+    uint32_t capacity, uint32_t period);
+
+/**
+ * @brief Attach an aperiodic task to a server, the task's priority is set to
+ * the server's priority, and its execution is charged to the server's budget
+ *
+ * @pre @p task is initialized, and isn't periodic
+ *
+ * @param [in] server pointer to the server
+ * @param [in] task pointer to the task
+ *
+ * @return void
+ * */
+void MIROS_ServerAttach(Server_t *server, Task_t *task);
+
+/**
+ * @brief Convert all servers' capacities to CPU cycles, at the current
+ * `SystemCoreClock`, and fill their budgets. Called by #MIROS_Start(), once
+ * the system clock is configured.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_ServerStart(void);
+
+/**
+ * @brief Charge a server for CPU cycles used by one of its tasks. Called by
+ * the kernel, with interrupts disabled.
+ *
+ * @param [in] server pointer to the server
+ * @param [in] cycles used CPU cycles
+ *
+ * @return void
+ * */
+void MIROS_ServerCharge(Server_t *server, uint32_t cycles);
+
+/**
+ * @brief Apply due budget replenishments. Called by the kernel from
+ * #MIROS_Tick(), with interrupts disabled.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_ServerTick(void);
+
+#endif /* _INC_MIROS_SERVER_H_ */
@@ -0,0 +1,201 @@
+/******************************************************************************
+ * @file    miros_syscall.h
+ * @brief   System calls, for unprivileged tasks
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_SYSCALL_H_
+#define _INC_MIROS_SYSCALL_H_
+
+/**
+ * Unprivileged tasks can't mask interrupts, so they can't run the kernel's
+ * critical sections, they call the kernel through the `SVC` instruction
+ * instead. The SVC handler takes the system call number from the `SVC`
+ * instruction, its arguments from the caller's stacked R0 - R2, calls the
+ * kernel function from a dispatch table (in privileged handler mode), and
+ * returns its result in the caller's stacked R0.
+ *
+ * The `MIROS_Sys...()` wrappers take a fast path for privileged callers
+ * (privileged tasks and ISRs), calling the kernel functions directly. Tasks
+ * that may run unprivileged use them instead of the kernel functions.
+ *
+ * > Requires miros_sem.h and miros_mutex.h to be included first
+ * */
+
+/**
+ * @brief System call numbers, `SVC` instruction's immediate
+ * */
+#define MIROS_SYSCALL_NULL              0
+#define MIROS_SYSCALL_TASK_DELAY        1
+#define MIROS_SYSCALL_TASK_WAIT_PERIOD  2
+#define MIROS_SYSCALL_SEM_WAIT          3
+#define MIROS_SYSCALL_SEM_TRY_WAIT      4
+#define MIROS_SYSCALL_SEM_POST          5
+#define MIROS_SYSCALL_MUTEX_LOCK        6
+#define MIROS_SYSCALL_MUTEX_UNLOCK      7
+#define MIROS_SYSCALL_TRACE_RECORD      8
+#define MIROS_SYSCALL_START             9
+#define MIROS_NUM_SYSCALLS              10
+
+/**
+ * @brief Value returned by an invalid system call
+ * */
+#define MIROS_SYSCALL_INVALID           0xFFFFFFFFUL
+
+/**
+ * @brief Check whether the caller is privileged (an ISR, or a privileged
+ * task), and can call the kernel directly
+ * */
+#define MIROS_SYSCALL_PRIVILEGED()      \
+  ((__get_IPSR() != 0) || ((__get_CONTROL() & CONTROL_nPRIV_Msk) == 0))
+
+/**
+ * @brief Execute system call @p number with 2 arguments, evaluates to the
+ * system call's result
+ * */
+#define MIROS_SVC(number, arg0, arg1)   \
+  ({  \
+    register uint32_t r0 __asm("r0") = (uint32_t) (arg0);  \
+    register uint32_t r1 __asm("r1") = (uint32_t) (arg1);  \
+    __asm volatile ("SVC %[n]" \
+        : "+r" (r0) : [n] "i" (number), "r" (r1) : "memory");  \
+    r0;  \
+  })
+
+/**
+ * @brief System call handler, called from SVC_Handler with a pointer to the
+ * caller's stacked exception frame (R0, R1, R2, R3, R12, LR, PC, xPSR)
+ *
+ * @param [in, out] frame pointer to the caller's exception frame
+ *
+ * @return void
+ * */
+void MIROS_SyscallDispatch(uint32_t *frame);
+
+/**
+ * @brief Measure the cost of a system call, against a direct call of the
+ * same (empty) kernel function, in CPU cycles using DWT cycle counter
+ *
+ * @pre Called from a privileged task (DWT is not accessible otherwise)
+ *
+ * @param [out] direct cycles taken by a direct call
+ * @param [out] svc cycles taken by a system call
+ *
+ * @return void
+ * */
+void MIROS_SyscallMeasure(uint32_t *direct, uint32_t *svc);
+
+/**
+ * @brief #MIROS_TaskDelay() system call
+ * */
+static inline void MIROS_SysTaskDelay(uint32_t ticks) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_TaskDelay(ticks);
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_TASK_DELAY, ticks, 0);
+  }
+}
+
+/**
+ * @brief #MIROS_TaskWaitPeriod() system call
+ * */
+static inline void MIROS_SysTaskWaitPeriod(void) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_TaskWaitPeriod();
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_TASK_WAIT_PERIOD, 0, 0);
+  }
+}
+
+/**
+ * @brief #MIROS_SemWait() system call
+ * */
+static inline void MIROS_SysSemWait(Semaphore_t *sem) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_SemWait(sem);
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_SEM_WAIT, sem, 0);
+  }
+}
+
+/**
+ * @brief #MIROS_SemTryWait() system call
+ * */
+static inline uint32_t MIROS_SysSemTryWait(Semaphore_t *sem) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    return MIROS_SemTryWait(sem);
+  }
+
+  return MIROS_SVC(MIROS_SYSCALL_SEM_TRY_WAIT, sem, 0);
+}
+
+/**
+ * @brief #MIROS_SemPost() system call
+ * */
+static inline void MIROS_SysSemPost(Semaphore_t *sem) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_SemPost(sem);
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_SEM_POST, sem, 0);
+  }
+}
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+/**
+ * @brief #MIROS_MutexLock() system call
+ * */
+static inline void MIROS_SysMutexLock(Mutex_t *mutex) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_MutexLock(mutex);
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_MUTEX_LOCK, mutex, 0);
+  }
+}
+
+/**
+ * @brief #MIROS_MutexUnlock() system call
+ * */
+static inline void MIROS_SysMutexUnlock(Mutex_t *mutex) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_MutexUnlock(mutex);
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_MUTEX_UNLOCK, mutex, 0);
+  }
+}
+#endif
+
+#if MIROS_TRACE_ENABLE
+/**
+ * @brief #MIROS_TraceRecord() system call
+ * */
+static inline void MIROS_SysTraceRecord(uint16_t event, uint16_t data) {
+  if (MIROS_SYSCALL_PRIVILEGED()) {
+    MIROS_TraceRecord(event, data);
+  } else {
+    (void) MIROS_SVC(MIROS_SYSCALL_TRACE_RECORD, event, data);
+  }
+}
+#endif
+
+#endif /* _INC_MIROS_SYSCALL_H_ */
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * @file    miros_timer.h
+ * @brief   Software timers, ticked by the kernel tick
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_TIMER_H_
+#define _INC_MIROS_TIMER_H_
+
+/**
+ * Software timers count kernel ticks, and call their callback from the
+ * kernel tick (SysTick's interrupt, in a critical section) when they
+ * expire. Callbacks must be short and must not block, they usually post a
+ * semaphore or an event. Callbacks may start and stop any timer: the
+ * expired timers are collected first, then their callbacks are called, and
+ * a timer stopped or re-armed by an earlier callback of the same tick isn't
+ * called.
+ *
+ * Armed timers are kept in a list, and each tick costs one decrement per
+ * armed timer.
+ *
+ * > Requires miros.h to be included first
+ * */
+
+struct Timer;
+
+/**
+ * @brief Timer callback, called from the kernel tick
+ *
+ * @param [in] timer pointer to the expired timer
+ * */
+typedef void (*TimerCallback_t)(struct Timer *timer);
+
+/**
+ * @brief Software timer
+ *
+ * struct Timer * next: next armed timer
+ * TimerCallback_t callback: called when the timer expires
+ * void * context: callback's context
+ * uint32_t remaining: ticks until the timer expires
+ * uint32_t period: reload value of periodic timers, 0 for one shot timers
+ * uint32_t armed: 1 while the timer is armed
+ * struct Timer * next_expired: next timer expired in the same tick
+ * uint32_t pending: 1 while the timer's callback is pending, in the tick it
+ *    expired
+ * */
+typedef struct Timer {
+  struct Timer *next;
+  TimerCallback_t callback;
+  void *context;
+  uint32_t remaining;
+  uint32_t period;
+  uint32_t armed;
+  struct Timer *next_expired;
+  uint32_t pending;
+} Timer_t;
+
+/**
+ * @brief Initialize a timer, disarmed
+ *
+ * @param [in] timer pointer to the timer
+ * @param [in] callback function called when the timer expires
+ * @param [in] context callback's context
+ *
+ * @return void
+ * */
+void MIROS_TimerInitialize(Timer_t *timer, TimerCallback_t callback,
+    void *context);
+
+/**
+ * @brief Arm the timer to expire after @p ticks, then every @p period
+ * ticks. Re-arms an armed timer.
+ *
+ * @param [in] timer pointer to the timer
+ * @param [in] ticks number of ticks until the timer expires, at least 1
+ * @param [in] period number of ticks between expirations, 0 for a one shot
+ *    timer
+ *
+ * @return void
+ * */
+void MIROS_TimerStart(Timer_t *timer, uint32_t ticks, uint32_t period);
+
+/**
+ * @brief Disarm the timer
+ *
+ * @param [in] timer pointer to the timer
+ *
+ * @return uint32_t: 1 if the timer was armed (or its callback pending), 0
+ *    otherwise
+ * */
+uint32_t MIROS_TimerStop(Timer_t *timer);
+
+/**
+ * @brief Count down armed timers, and call the callbacks of the expired
+ * ones. Called by the kernel tick.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_TimerTick(void);
+
+#endif /* _INC_MIROS_TIMER_H_ */
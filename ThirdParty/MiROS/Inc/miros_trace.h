@@ -0,0 +1,152 @@
+/******************************************************************************
+ * @file    miros_trace.h
+ * @brief   MiROS RAM trace buffer of kernel events and application log records
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_TRACE_H_
+#define _INC_MIROS_TRACE_H_
+
+/**
+ * @brief Number of records the RAM trace buffer can hold. Records are
+ * dropped when the buffer is full, until they are read.
+ * */
+#ifndef MIROS_TRACE_BUFFER_SIZE
+#define MIROS_TRACE_BUFFER_SIZE     64
+#endif
+
+/**
+ * @brief Kernel trace events, their data is the task's id
+ *
+ * MIROS_TRACE_SWITCH: the scheduler switched to a task
+ * MIROS_TRACE_BLOCK: a task blocked
+ * MIROS_TRACE_UNBLOCK: a task was unblocked
+ * MIROS_TRACE_BOOT: system reset, data is the reset flags (RCC->CSR >> 24)
+ * MIROS_TRACE_OVERRUN: a periodic task exhausted its budget
+ * MIROS_TRACE_MODE: criticality mode switch, data is the new mode
+ * MIROS_TRACE_KERNEL_MAX: kernel events are less than this value (they
+ *    are bits of the trace mask), events from this value up to
+ *    MIROS_TRACE_USER are invalid
+ * MIROS_TRACE_USER: first application event, application log records use
+ *    events starting from this value (up to 0xFFFE)
+ * MIROS_TRACE_RESERVED: reserved, an erased record in flash
+ * */
+#define MIROS_TRACE_SWITCH          0x0000
+#define MIROS_TRACE_BLOCK           0x0001
+#define MIROS_TRACE_UNBLOCK         0x0002
+#define MIROS_TRACE_BOOT            0x0003
+#define MIROS_TRACE_OVERRUN         0x0004
+#define MIROS_TRACE_MODE            0x0005
+#define MIROS_TRACE_KERNEL_MAX      0x0020
+#define MIROS_TRACE_USER            0x0100
+#define MIROS_TRACE_RESERVED        0xFFFF
+
+/**
+ * @brief Default mask of recorded kernel events (bit n enables event n).
+ * Task switches happen every tick with round robin scheduling, so they are
+ * not recorded by default.
+ * */
+#define MIROS_TRACE_DEFAULT_MASK    \
+  ((1UL << MIROS_TRACE_BLOCK) | (1UL << MIROS_TRACE_UNBLOCK) \
+      | (1UL << MIROS_TRACE_BOOT) | (1UL << MIROS_TRACE_OVERRUN) \
+      | (1UL << MIROS_TRACE_MODE))
+
+/**
+ * @brief No ignored task, see #MIROS_TraceIgnoreTask()
+ * */
+#define MIROS_TRACE_NO_TASK         0xFFFFFFFF
+
+/**
+ * @brief Trace record
+ *
+ * uint32_t timestamp: HAL tick (ms) when the record was taken
+ * uint16_t data: event's data
+ * uint16_t event: event's id, 0xFFFF is reserved (erased flash)
+ *
+ * > The event is the last member, so when records are programmed into flash
+ * > the event half-word is programmed last, and marks the record as valid.
+ * */
+typedef struct {
+  uint32_t timestamp;
+  uint16_t data;
+  uint16_t event;
+} TraceRecord_t;
+
+/**
+ * @brief Add a record to the trace buffer. Can be called from both task and
+ * interrupt contexts.
+ *
+ * @param [in] event event's id, kernel events that aren't enabled by
+ *    #MIROS_TraceSetMask() are ignored, as are invalid events (from
+ *    #MIROS_TRACE_KERNEL_MAX to #MIROS_TRACE_USER - 1) and
+ *    #MIROS_TRACE_RESERVED
+ * @param [in] data event's data
+ *
+ * @return void
+ * */
+void MIROS_TraceRecord(uint16_t event, uint16_t data);
+
+/**
+ * @brief Remove up to @p count of the oldest records from the trace buffer
+ *
+ * @param [out] records buffer to receive the records
+ * @param [in] count maximum number of records to read
+ *
+ * @return uint32_t: number of records read
+ * */
+uint32_t MIROS_TraceRead(TraceRecord_t *records, uint32_t count);
+
+/**
+ * @brief Get the number of records in the trace buffer
+ * */
+uint32_t MIROS_TraceCount(void);
+
+/**
+ * @brief Get the number of records dropped because the trace buffer was full
+ * */
+uint32_t MIROS_TraceDropped(void);
+
+/**
+ * @brief Select the recorded kernel events (bit n enables event n),
+ * application events are always recorded
+ *
+ * @param [in] mask kernel events mask
+ *
+ * @return void
+ * */
+void MIROS_TraceSetMask(uint32_t mask);
+
+/**
+ * @brief Stop recording the kernel events of a task (its switches, blocks,
+ * unblocks and overruns). Used while the trace buffer is written to flash,
+ * as the writing task's own waits would refill the buffer.
+ *
+ * @param [in] id ignored task's id, or #MIROS_TRACE_NO_TASK to record the
+ *    events of all tasks
+ *
+ * @return void
+ * */
+void MIROS_TraceIgnoreTask(uint32_t id);
+
+#endif /* _INC_MIROS_TRACE_H_ */
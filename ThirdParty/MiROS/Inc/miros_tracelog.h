@@ -0,0 +1,113 @@
+/******************************************************************************
+ * @file    miros_tracelog.h
+ * @brief   MiROS persistent flash ring of trace records, surviving resets
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_TRACELOG_H_
+#define _INC_MIROS_TRACELOG_H_
+
+/**
+ * @brief Address of the first flash page used by the trace log. Must be
+ * reserved in the linker script, so no code or data is placed there.
+ * */
+#ifndef MIROS_TRACELOG_FIRST_PAGE
+#define MIROS_TRACELOG_FIRST_PAGE   0x0801B000
+#endif
+
+/**
+ * @brief Number of flash pages used by the trace log (at least 2). Each page
+ * holds (FLASH_PAGE_SIZE / 8 - 1) records.
+ * */
+#ifndef MIROS_TRACELOG_NUM_PAGES
+#define MIROS_TRACELOG_NUM_PAGES    16
+#endif
+
+/**
+ * @brief Maximum number of records programmed in a single flash request
+ * */
+#ifndef MIROS_TRACELOG_BATCH_SIZE
+#define MIROS_TRACELOG_BATCH_SIZE   16
+#endif
+
+/**
+ * @brief Trace log task's flush period, in OS ticks. The RAM trace buffer
+ * must be large enough to hold the records produced in this period.
+ * */
+#ifndef MIROS_TRACELOG_FLUSH_PERIOD
+#define MIROS_TRACELOG_FLUSH_PERIOD 100
+#endif
+
+/**
+ * @brief Initialize the trace log. Locates the head of the log in flash,
+ * using a binary search over the pages' sequence numbers, then over the
+ * records of the head page. Then records a #MIROS_TRACE_BOOT event, with
+ * the reset flags.
+ *
+ * Pages are written in circular order, each page starts with a header that
+ * holds an increasing sequence number, so the newest page is the last one
+ * whose sequence number is not less than the first page's.
+ *
+ * @pre #MIROS_FlashInitialize() was called
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_TraceLogInitialize(void);
+
+/**
+ * @brief Move the records in the RAM trace buffer to the flash log, in
+ * batches of up to #MIROS_TRACELOG_BATCH_SIZE records. When the head page is
+ * full, the next page (the oldest) is erased, and becomes the head.
+ *
+ * Only the records present on entry are moved, records added meanwhile are
+ * left to the next flush. The calling task's kernel events aren't recorded
+ * while it flushes, see #MIROS_TraceIgnoreTask().
+ *
+ * @pre Called from a task's context, not from an ISR
+ *
+ * @param void
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if all records were written
+ * */
+HAL_StatusTypeDef MIROS_TraceLogFlush(void);
+
+/**
+ * @brief Get a record from the flash log
+ *
+ * @param [in] age record's age, 0 is the newest record in the log
+ *
+ * @return const TraceRecord_t *: pointer to the record in flash, or NULL if
+ *    the log holds fewer records
+ * */
+const TraceRecord_t* MIROS_TraceLogGet(uint32_t age);
+
+/**
+ * @brief Trace log task handle, flushes the trace buffer every
+ * #MIROS_TRACELOG_FLUSH_PERIOD ticks. Should be added as a low priority task.
+ * */
+void MIROS_TraceLogTask(void);
+
+#endif /* _INC_MIROS_TRACELOG_H_ */
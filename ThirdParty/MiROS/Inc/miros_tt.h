@@ -0,0 +1,139 @@
+/******************************************************************************
+ * @file    miros_tt.h
+ * @brief   Time-triggered cyclic executive
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_MIROS_TT_H_
+#define _INC_MIROS_TT_H_
+
+/**
+ * The cyclic executive dispatches jobs from a static schedule table,
+ * generated offline and placed in flash (a `const` table). Each entry gives
+ * the job's offset within the hyperperiod, and the table is repeated every
+ * hyperperiod. Jobs are dispatched from a timer's output compare interrupt,
+ * and run to completion in the interrupt, there are no scheduling decisions
+ * at run time: the next compare is armed from the next table entry before
+ * the job is called, so job's start jitter is only the interrupt latency.
+ *
+ * MiROS tasks run in the slack time between jobs. The timer interrupt's
+ * priority must be higher than SysTick's and PendSV's, and jobs must not
+ * call blocking MiROS functions, they can hand work over to tasks by posting
+ * semaphores.
+ *
+ * The timer is configured by the application: counting up at the schedule's
+ * time unit (1 MHz for microsecond offsets), with a period (ARR) of 0xFFFF,
+ * and the compare channel in timing mode. Its interrupt handler calls
+ * #MIROS_TtIRQHandler().
+ * */
+
+/**
+ * @brief Largest compare step, gaps between jobs that are longer than one
+ * timer period are split into steps of this size
+ * */
+#define MIROS_TT_MAX_STEP           0xFFFFUL
+
+/**
+ * @brief Delay between #MIROS_TtStart() and the start of the first
+ * hyperperiod, in timer ticks
+ * */
+#ifndef MIROS_TT_START_DELAY
+#define MIROS_TT_START_DELAY        100
+#endif
+
+/**
+ * @brief Time-triggered job, runs to completion in the timer's interrupt
+ * */
+typedef void (*TtJob_t)(void);
+
+/**
+ * @brief Schedule table entry
+ *
+ * uint32_t offset: job's start time, in timer ticks from the start of the
+ *    hyperperiod
+ * TtJob_t job: job's function
+ * */
+typedef struct {
+  uint32_t offset;
+  TtJob_t job;
+} TtEntry_t;
+
+/**
+ * @brief Schedule table
+ *
+ * const TtEntry_t * entries: table entries, sorted by strictly increasing
+ *    offsets, all less than the hyperperiod
+ * uint32_t num_entries: number of entries
+ * uint32_t hyperperiod: hyperperiod's length, in timer ticks
+ * */
+typedef struct {
+  const TtEntry_t *entries;
+  uint32_t num_entries;
+  uint32_t hyperperiod;
+} TtSchedule_t;
+
+/**
+ * @brief Start dispatching jobs from @p schedule. The first hyperperiod
+ * starts #MIROS_TT_START_DELAY timer ticks later.
+ *
+ * @param [in] htim pointer to the timer's handle
+ * @param [in] channel timer's compare channel (TIM_CHANNEL_1 to 4)
+ * @param [in] schedule pointer to the schedule table
+ *
+ * @return HAL_StatusTypeDef: HAL_OK if the timer was started, an error
+ *    otherwise
+ * */
+HAL_StatusTypeDef MIROS_TtStart(TIM_HandleTypeDef *htim, uint32_t channel,
+    const TtSchedule_t *schedule);
+
+/**
+ * @brief Stop dispatching jobs
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_TtStop(void);
+
+/**
+ * @brief Get the number of jobs that ran past the next job's start time
+ * (the next job is dispatched late)
+ *
+ * @param void
+ *
+ * @return uint32_t: number of overruns
+ * */
+uint32_t MIROS_TtOverruns(void);
+
+/**
+ * @brief Timer interrupt handler, must be called from the timer's IRQ
+ * handler (instead of HAL_TIM_IRQHandler()).
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void MIROS_TtIRQHandler(void);
+
+#endif /* _INC_MIROS_TT_H_ */
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * @file    priority.h
+ * @brief   Preemptive fixed priority scheduler
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _INC_PRIORITY_H_
+#define _INC_PRIORITY_H_
+
+/**
+ * Each task has a fixed priority (#TaskAttributes_t), the highest priority
+ * ready task is always the one executed, and preempts lower priority tasks
+ * as soon as it becomes ready. Tasks of the same priority are executed in
+ * turns, switching at every OS tick (so, when all tasks have the same
+ * priority, it behaves like the round robin scheduler).
+ *
+ * Ready tasks are kept in 2 bitmaps: one of the ready task ids, and one of
+ * the priority levels that have at least 1 ready task. So selecting the next
+ * task takes constant time (2 `CLZ` instructions), regardless of the number
+ * of tasks.
+ *
+ * The scheduler also keeps a system ceiling, used by the stack resource
+ * policy (miros_mutex.h): while the ceiling is set, only tasks whose priority
+ * is above the ceiling can preempt the ceiling's owner.
+ *
+ * With #MIROS_FAIR_SHARE, tasks of level #MIROS_FAIR_PRIORITY (just above
+ * the default level) are not executed in turns, the one with the lowest
+ * virtual runtime is selected instead.
+ *
+ * Preemption thresholds use the same ceiling: when a task whose threshold is
+ * above its priority is switched in, the ceiling is raised to its threshold
+ * until the task blocks. So a preempted task resumes before any other task
+ * within its threshold, and such tasks never preempt each other (or time
+ * slice), which cuts the number of task switches.
+ * */
+
+/**
+ * @brief Initialize the scheduler
+ *
+ * @param void
+ * @return void
+ * */
+void Scheduler_Initialize(void);
+
+/**
+ * @brief Add task to the scheduler
+ *
+ * @pre Scheduler is initialized by calling #Scheduler_Initialize()
+ * @pre Task is initialized, and its priority is less than
+ *    #MIROS_NUM_PRIORITIES
+ *
+ * @post @p task is added to the scheduler, and will be scheduled according
+ *    to its priority
+ *
+ * @param [in] pointer to the task to be added
+ * */
+void Scheduler_AddTask(Task_t *task);
+
+/**
+ * @brief Get next task to be executed
+ *
+ * The running task keeps running, unless a higher priority task is ready,
+ * or its time slice expired (#Scheduler_Tick()) and another task of the same
+ * priority is ready.
+ *
+ * @pre Scheduler is initialized by calling #Scheduler_Initialize()
+ *
+ * @param void
+ *
+ * @return Task_t *: pointer to the next ready task to be executed, or NULL
+ *    if all tasks are blocked
+ * */
+Task_t* Scheduler_GetTask(void);
+
+/**
+ * @brief Notify the scheduler that @p task became ready
+ *
+ * @param [in] task pointer to the task that became ready
+ *
+ * @return uint32_t: 1 if @p task should preempt the running task (the
+ *    caller must call #MIROS_Sched()), 0 otherwise
+ * */
+uint32_t Scheduler_ReadyTask(Task_t *task);
+
+/**
+ * @brief Notify the scheduler that @p task is blocked
+ *
+ * @param [in] task pointer to the blocked task
+ *
+ * @return void
+ * */
+void Scheduler_BlockTask(Task_t *task);
+
+/**
+ * @brief Notify the scheduler of an OS tick, ends the running task's time
+ * slice
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void Scheduler_Tick(void);
+
+/**
+ * @brief Change @p task's priority, the task keeps its state (ready or
+ * blocked). The caller must call #MIROS_Sched() for the change to take
+ * effect.
+ *
+ * @param [in] task pointer to the task
+ * @param [in] priority task's new priority, less than #MIROS_NUM_PRIORITIES
+ *
+ * @return void
+ * */
+void Scheduler_SetPriority(Task_t *task, uint32_t priority);
+
+/**
+ * @brief Restrict scheduling to a set of tasks (a time partition's tasks),
+ * other tasks are not scheduled even if they are ready. The caller must call
+ * #MIROS_Sched() for the change to take effect.
+ *
+ * @param [in] tasks set of task ids (bit n is the task of id n), all ones to
+ *    schedule all tasks
+ *
+ * @return void
+ * */
+void Scheduler_SetActiveTasks(uint32_t tasks);
+
+/**
+ * @brief Drop a set of tasks (low criticality tasks in high criticality
+ * mode), they are not scheduled even if they are ready or active. The caller
+ * must call #MIROS_Sched() for the change to take effect.
+ *
+ * @param [in] tasks set of task ids (bit n is the task of id n), 0 to drop
+ *    no task
+ *
+ * @return void
+ * */
+void Scheduler_SetDroppedTasks(uint32_t tasks);
+
+/**
+ * @brief Set the system ceiling
+ *
+ * @param [in] ceiling the new system ceiling (a priority level)
+ * @param [in] owner the task that set the ceiling, which runs instead of
+ *    the ready tasks whose priority is less than or equal to @p ceiling. Or
+ *    NULL to clear the ceiling
+ *
+ * @return void
+ * */
+void Scheduler_SetCeiling(uint32_t ceiling, Task_t *owner);
+
+/**
+ * @brief Get the system ceiling
+ *
+ * @param [out] owner the task that set the ceiling, NULL if it's not set
+ *
+ * @return uint32_t: the system ceiling
+ * */
+uint32_t Scheduler_GetCeiling(Task_t **owner);
+
+#endif /* _INC_PRIORITY_H_ */
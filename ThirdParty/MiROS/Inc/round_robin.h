@@ -57,8 +57,50 @@ void Scheduler_AddTask(Task_t *task);
  *
  * @param void
  *
- * @return Task_t *: pointer to the next task to be executed
+ * @return Task_t *: pointer to the next ready task to be executed, or NULL
+ *    if all tasks are blocked
  * */
 Task_t* Scheduler_GetTask(void);
 
+/**
+ * @brief Notify the scheduler that @p task became ready. Tasks are executed
+ * in turns, so a ready task never preempts the running task.
+ *
+ * @param [in] task pointer to the task that became ready
+ *
+ * @return uint32_t: always 0, no rescheduling is required
+ * */
+uint32_t Scheduler_ReadyTask(Task_t *task);
+
+/**
+ * @brief Notify the scheduler that @p task is blocked. Blocked tasks are
+ * skipped by #Scheduler_GetTask(), nothing else to be done.
+ *
+ * @param [in] task pointer to the blocked task
+ *
+ * @return void
+ * */
+void Scheduler_BlockTask(Task_t *task);
+
+/**
+ * @brief Notify the scheduler of an OS tick. The running task is switched
+ * out by every call to #Scheduler_GetTask(), nothing else to be done.
+ *
+ * @param void
+ *
+ * @return void
+ * */
+void Scheduler_Tick(void);
+
+/**
+ * @brief Change @p task's priority. Priorities are not used by the round
+ * robin scheduler, the priority is only recorded.
+ *
+ * @param [in] task pointer to the task
+ * @param [in] priority task's new priority
+ *
+ * @return void
+ * */
+void Scheduler_SetPriority(Task_t *task, uint32_t priority);
+
 #endif /* _INC_ROUND_ROBIN_H_ */
@@ -0,0 +1,1512 @@
+/******************************************************************************
+ * @file    cmsis_os2.c
+ * @brief   CMSIS-RTOS2 API, implemented on top of MiROS
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+#include "priority.h"
+#include "miros_mutex.h"
+#else
+#include "round_robin.h"
+#endif
+#include "cmsis_os2.h"
+#include "miros_os2.h"
+
+/**
+ * @brief CMSIS-RTOS2 API version implemented (2.1.3), and MiROS version
+ * (0.1.0), encoded as `major * 10000000 + minor * 10000 + patch`
+ * */
+#define OS2_API_VERSION       20010003U
+#define OS2_KERNEL_VERSION    10000U
+#define OS2_KERNEL_ID         "MiROS"
+
+/**
+ * @brief Check whether the caller is an ISR
+ * */
+#define OS2_IN_ISR()          (__get_IPSR() != 0U)
+
+/**
+ * @brief Number of control blocks in a static pool
+ * */
+#define OS2_COUNT(pool)       (sizeof(pool) / sizeof((pool)[0]))
+
+/**
+ * @brief Get the control block given in @p attr, or take one from @p pool
+ * */
+#define OS2_CONTROL_BLOCK(attr, pool, used)   \
+  Os2_ControlBlock((attr)->cb_mem, (attr)->cb_size, (pool), (used), \
+      OS2_COUNT(pool), sizeof((pool)[0]))
+
+/**
+ * @brief Give @p cb back to @p pool, if it was taken from it
+ * */
+#define OS2_POOL_GIVE(pool, used, cb)   \
+  Os2_PoolGive((pool), (used), OS2_COUNT(pool), sizeof((pool)[0]), (cb))
+
+static osKernelState_t Os2_KernelState = osKernelInactive;
+
+static __ALIGNED(8) uint32_t Os2_IdleStack[MIROS_OS2_IDLE_STACK_SIZE];
+
+static Task_t Os2_TimerTask;
+static __ALIGNED(8) uint32_t Os2_TimerStack[MIROS_OS2_TIMER_STACK_SIZE];
+
+/**
+ * @brief Started timers, and the timer task's wake up semaphore (posted
+ * when a timer is started while no timer is)
+ * */
+static Os2Timer_t *Os2_Timers = NULL;
+static Semaphore_t Os2_TimerWake;
+
+/**
+ * @brief Static pools, of the objects created without control blocks (or
+ * stacks), and the arena that pools' and queues' storage is reserved from
+ * */
+static Os2Thread_t Os2_ThreadPool[MIROS_OS2_MAX_THREADS];
+static uint8_t Os2_ThreadUsed[MIROS_OS2_MAX_THREADS];
+static __ALIGNED(8) uint32_t
+Os2_StackPool[MIROS_OS2_MAX_THREADS][MIROS_OS2_THREAD_STACK_SIZE];
+static uint8_t Os2_StackUsed[MIROS_OS2_MAX_THREADS];
+static Os2Timer_t Os2_TimerPool[MIROS_OS2_MAX_TIMERS];
+static uint8_t Os2_TimerUsed[MIROS_OS2_MAX_TIMERS];
+static Os2EventFlags_t Os2_EventFlagsPool[MIROS_OS2_MAX_EVENT_FLAGS];
+static uint8_t Os2_EventFlagsUsed[MIROS_OS2_MAX_EVENT_FLAGS];
+static Os2Mutex_t Os2_MutexPool[MIROS_OS2_MAX_MUTEXES];
+static uint8_t Os2_MutexUsed[MIROS_OS2_MAX_MUTEXES];
+static Os2Semaphore_t Os2_SemaphorePool[MIROS_OS2_MAX_SEMAPHORES];
+static uint8_t Os2_SemaphoreUsed[MIROS_OS2_MAX_SEMAPHORES];
+static Os2MemoryPool_t Os2_MemoryPoolPool[MIROS_OS2_MAX_MEMORY_POOLS];
+static uint8_t Os2_MemoryPoolUsed[MIROS_OS2_MAX_MEMORY_POOLS];
+static Os2MessageQueue_t Os2_MessageQueuePool[MIROS_OS2_MAX_MESSAGE_QUEUES];
+static uint8_t Os2_MessageQueueUsed[MIROS_OS2_MAX_MESSAGE_QUEUES];
+static uint32_t Os2_Arena[MIROS_OS2_ARENA_SIZE / sizeof(uint32_t)];
+static uint32_t Os2_ArenaUsed = 0;
+
+/**
+ * @brief Idle task
+ * */
+static void Os2_Idle(void) {
+  for (;;) {
+  }
+}
+
+/**
+ * @brief Take a free control block from a static pool
+ *
+ * @param [in] pool pool's control blocks
+ * @param [in] used pool's used flags
+ * @param [in] count number of control blocks in the pool
+ * @param [in] size control block's size
+ *
+ * @return void*: control block, or NULL if they're all used
+ * */
+static void* Os2_PoolTake(void *pool, uint8_t *used, uint32_t count,
+    uint32_t size) {
+  void *cb = NULL;
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+  for (uint32_t i = 0; i < count; i++) {
+    if (!used[i]) {
+      used[i] = 1;
+      cb = (uint8_t*) pool + (i * size);
+      break;
+    }
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  return cb;
+}
+
+/**
+ * @brief Give a control block back to a static pool, if it was taken from
+ * it (not given by the application)
+ *
+ * @param [in] pool pool's control blocks
+ * @param [in] used pool's used flags
+ * @param [in] count number of control blocks in the pool
+ * @param [in] size control block's size
+ * @param [in] cb control block
+ *
+ * @return void
+ * */
+static void Os2_PoolGive(void *pool, uint8_t *used, uint32_t count,
+    uint32_t size, void *cb) {
+  uint32_t offset = (uint32_t) ((uint8_t*) cb - (uint8_t*) pool);
+
+  if (((uint8_t*) cb >= (uint8_t*) pool) && (offset < (count * size))) {
+    used[offset / size] = 0;
+  }
+}
+
+/**
+ * @brief Get an object's control block: the one given in its attributes
+ * (@p cb_mem), or a free one from a static pool if it's NULL
+ *
+ * @return void*: control block, or NULL if the given one is too small, or
+ *    the pool is exhausted
+ * */
+static void* Os2_ControlBlock(void *cb_mem, uint32_t cb_size, void *pool,
+    uint8_t *used, uint32_t count, uint32_t size) {
+  if (cb_mem != NULL) {
+    return (cb_size < size) ? NULL : cb_mem;
+  }
+
+  return Os2_PoolTake(pool, used, count, size);
+}
+
+/**
+ * @brief Reserve @p size bytes (word aligned) from the static arena, for
+ * memory pools' and message queues' storage. The arena isn't reclaimed.
+ *
+ * @return void*: reserved storage, or NULL if the arena is exhausted
+ * */
+static void* Os2_Reserve(uint32_t size) {
+  void *mem = NULL;
+  uint32_t primask;
+
+  size = (size + 3U) & ~3U;
+
+  MIROS_CRITICAL_ENTER(primask);
+  if ((Os2_ArenaUsed + size) <= sizeof(Os2_Arena)) {
+    mem = (uint8_t*) Os2_Arena + Os2_ArenaUsed;
+    Os2_ArenaUsed += size;
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  return mem;
+}
+
+/**
+ * @brief Acquire a semaphore token within @p timeout ticks. Timeouts other
+ * than 0 and osWaitForever are polled once every tick.
+ *
+ * @param [in] sem pointer to the semaphore
+ * @param [in] timeout timeout, in ticks
+ *
+ * @return osStatus_t: osOK, osErrorResource (no token, and @p timeout is
+ *    0), osErrorTimeout, or osErrorParameter (ISR with a timeout)
+ * */
+static osStatus_t Os2_SemAcquire(Semaphore_t *sem, uint32_t timeout) {
+  if (MIROS_SemTryWait(sem)) {
+    return osOK;
+  }
+
+  if (timeout == 0) {
+    return osErrorResource;
+  }
+
+  if (OS2_IN_ISR()) {
+    return osErrorParameter;
+  }
+
+  if (timeout == osWaitForever) {
+    MIROS_SemWait(sem);
+    return osOK;
+  }
+
+  do {
+    MIROS_TaskDelay(1);
+    timeout--;
+    if (MIROS_SemTryWait(sem)) {
+      return osOK;
+    }
+  } while (timeout > 0);
+
+  return osErrorTimeout;
+}
+
+/**
+ * @brief Count down started timers by 1 tick, marks expired timers as
+ * pending, and removes timers that are neither running nor pending from the
+ * started timers list
+ *
+ * @param void
+ *
+ * @return void
+ * */
+static void Os2_TimerTick(void) {
+  Os2Timer_t **link = &Os2_Timers;
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  while (*link != NULL) {
+    Os2Timer_t *timer = *link;
+
+    if (timer->running && (--timer->remaining == 0)) {
+      timer->pending = 1;
+      if (timer->type == osTimerPeriodic) {
+        timer->remaining = timer->period;
+      } else {
+        timer->running = 0;
+      }
+    }
+
+    if (!timer->running && !timer->pending) {
+      *link = timer->next;
+      timer->linked = 0;
+    } else {
+      link = &timer->next;
+    }
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+/**
+ * @brief Call pending timers' callbacks, outside of the critical section (a
+ * callback may start or stop timers)
+ *
+ * @param void
+ *
+ * @return void
+ * */
+static void Os2_TimerDispatch(void) {
+  uint32_t primask;
+
+  for (;;) {
+    Os2Timer_t *timer;
+    osTimerFunc_t func = NULL;
+    void *argument = NULL;
+
+    MIROS_CRITICAL_ENTER(primask);
+    for (timer = Os2_Timers; timer != NULL; timer = timer->next) {
+      if (timer->pending) {
+        timer->pending = 0;
+        func = timer->func;
+        argument = timer->argument;
+        break;
+      }
+    }
+    MIROS_CRITICAL_EXIT(primask);
+
+    if (func == NULL) {
+      break;
+    }
+
+    func(argument);
+  }
+}
+
+/**
+ * @brief Timer task, counts down started timers once every tick and calls
+ * the expired timers' callbacks. Sleeps while no timer is started.
+ * */
+static void Os2_TimerThread(void) {
+  uint32_t primask;
+
+  for (;;) {
+    MIROS_CRITICAL_ENTER(primask);
+    if (Os2_Timers == NULL) {
+      MIROS_CRITICAL_EXIT(primask);
+      MIROS_SemWait(&Os2_TimerWake);
+      continue;
+    }
+    MIROS_CRITICAL_EXIT(primask);
+
+    MIROS_TaskDelay(1);
+    Os2_TimerTick();
+    Os2_TimerDispatch();
+  }
+}
+
+/**
+ * @brief Threads' entry, calls the thread's function with its argument,
+ * then ends the thread if the function returns
+ * */
+static void Os2_ThreadStart(void) {
+  Os2Thread_t *thread = (Os2Thread_t*) MIROS_GetRunningTask();
+
+  thread->func(thread->argument);
+
+  osThreadExit();
+}
+
+/*  Kernel  */
+
+osStatus_t osKernelInitialize(void) {
+  TaskAttributes_t attributes = { 0 };
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (Os2_KernelState != osKernelInactive) {
+    return osError;
+  }
+
+  MIROS_Initialize(Os2_Idle, Os2_IdleStack, MIROS_OS2_IDLE_STACK_SIZE);
+
+  /* timer task, runs timers' callbacks */
+  Os2_Timers = NULL;
+  MIROS_SemInitialize(&Os2_TimerWake, 0);
+  attributes.priority = MIROS_OS2_TIMER_PRIORITY;
+  if (MIROS_TaskInitializeWithAttributes(&Os2_TimerTask, Os2_TimerThread,
+      Os2_TimerStack, MIROS_OS2_TIMER_STACK_SIZE, &attributes) != HAL_OK) {
+    return osError;
+  }
+
+  /* system timer, DWT cycle counter */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  Os2_KernelState = osKernelReady;
+
+  return osOK;
+}
+
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf,
+    uint32_t id_size) {
+  if (version != NULL) {
+    version->api = OS2_API_VERSION;
+    version->kernel = OS2_KERNEL_VERSION;
+  }
+
+  if ((id_buf != NULL) && (id_size > 0)) {
+    strncpy(id_buf, OS2_KERNEL_ID, id_size - 1);
+    id_buf[id_size - 1] = '\0';
+  }
+
+  return osOK;
+}
+
+osKernelState_t osKernelGetState(void) {
+  return Os2_KernelState;
+}
+
+osStatus_t osKernelStart(void) {
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (Os2_KernelState != osKernelReady) {
+    return osError;
+  }
+
+  Os2_KernelState = osKernelRunning;
+  MIROS_Start();
+}
+
+uint32_t osKernelGetTickCount(void) {
+  return HAL_GetTick();
+}
+
+uint32_t osKernelGetTickFreq(void) {
+  return 1000U / (uint32_t) HAL_GetTickFreq();
+}
+
+uint32_t osKernelGetSysTimerCount(void) {
+  return DWT->CYCCNT;
+}
+
+uint32_t osKernelGetSysTimerFreq(void) {
+  return SystemCoreClock;
+}
+
+/*  Threads  */
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument,
+    const osThreadAttr_t *attr) {
+  TaskAttributes_t attributes = { 0 };
+  osThreadAttr_t defaults = { 0 };
+  osPriority_t priority = osPriorityNormal;
+  Os2Thread_t *thread;
+  uint32_t *stack = NULL;
+  uint32_t stack_size;
+  HAL_StatusTypeDef status;
+  uint32_t primask;
+
+  if ((func == NULL) || OS2_IN_ISR()) {
+    return NULL;
+  }
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  if (attr->priority != osPriorityNone) {
+    priority = attr->priority;
+  }
+
+  if ((priority < osPriorityIdle) || (priority >= osPriorityISR)) {
+    return NULL;
+  }
+
+  /* a pooled stack, if none is given, fits the asked size */
+  stack_size = attr->stack_size;
+  if (attr->stack_mem != NULL) {
+    if (stack_size == 0) {
+      return NULL;
+    }
+  } else if (stack_size > sizeof(Os2_StackPool[0])) {
+    return NULL;
+  } else {
+    stack_size = sizeof(Os2_StackPool[0]);
+  }
+
+  thread = OS2_CONTROL_BLOCK(attr, Os2_ThreadPool, Os2_ThreadUsed);
+  if (thread == NULL) {
+    return NULL;
+  }
+
+  stack = attr->stack_mem;
+  if (stack == NULL) {
+    stack = Os2_PoolTake(Os2_StackPool, Os2_StackUsed,
+        OS2_COUNT(Os2_StackPool), sizeof(Os2_StackPool[0]));
+  }
+
+  if (stack == NULL) {
+    OS2_POOL_GIVE(Os2_ThreadPool, Os2_ThreadUsed, thread);
+    return NULL;
+  }
+
+  thread->func = func;
+  thread->argument = argument;
+  thread->name = attr->name;
+  thread->priority = priority;
+
+  attributes.priority = MIROS_OS2_PRIORITY(priority);
+
+  MIROS_CRITICAL_ENTER(primask);
+  status = MIROS_TaskInitializeWithAttributes(&thread->task, Os2_ThreadStart,
+      stack, stack_size / sizeof(uint32_t), &attributes);
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (status != HAL_OK) {
+    OS2_POOL_GIVE(Os2_StackPool, Os2_StackUsed, stack);
+    OS2_POOL_GIVE(Os2_ThreadPool, Os2_ThreadUsed, thread);
+    return NULL;
+  }
+
+  /* created by a running thread, may preempt it */
+  if (Os2_KernelState == osKernelRunning) {
+    MIROS_Sched();
+  }
+
+  return thread;
+}
+
+const char* osThreadGetName(osThreadId_t thread_id) {
+  Os2Thread_t *thread = thread_id;
+
+  return (thread == NULL) ? NULL : thread->name;
+}
+
+osThreadId_t osThreadGetId(void) {
+  return MIROS_GetRunningTask();
+}
+
+osThreadState_t osThreadGetState(osThreadId_t thread_id) {
+  Os2Thread_t *thread = thread_id;
+
+  if (thread == NULL) {
+    return osThreadError;
+  }
+
+  if (&thread->task == MIROS_GetRunningTask()) {
+    return osThreadRunning;
+  }
+
+  return (thread->task.state == MIROS_TASK_READY) ?
+      osThreadReady : osThreadBlocked;
+}
+
+uint32_t osThreadGetStackSize(osThreadId_t thread_id) {
+  Os2Thread_t *thread = thread_id;
+
+  return (thread == NULL) ? 0 : thread->task.stack_size * sizeof(uint32_t);
+}
+
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
+  Os2Thread_t *thread = thread_id;
+  uint32_t primask;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if ((thread == NULL) || (priority < osPriorityIdle)
+      || (priority >= osPriorityISR)) {
+    return osErrorParameter;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  thread->priority = priority;
+  Scheduler_SetPriority(&thread->task, MIROS_OS2_PRIORITY(priority));
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_Sched();
+
+  return osOK;
+}
+
+osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
+  Os2Thread_t *thread = thread_id;
+
+  return (thread == NULL) ? osPriorityError : thread->priority;
+}
+
+osStatus_t osThreadYield(void) {
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  MIROS_Sched();
+
+  return osOK;
+}
+
+void osThreadExit(void) {
+  uint32_t primask;
+
+  /* MiROS tasks don't end, the thread stays blocked */
+  for (;;) {
+    MIROS_CRITICAL_ENTER(primask);
+    MIROS_TaskBlock();
+    MIROS_CRITICAL_EXIT(primask);
+  }
+}
+
+/*  Delays  */
+
+osStatus_t osDelay(uint32_t ticks) {
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  MIROS_TaskDelay(ticks);
+
+  return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks) {
+  uint32_t delay = ticks - osKernelGetTickCount();
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  /* in the past (or too far in the future) */
+  if ((delay == 0) || (delay > 0x7FFFFFFFU)) {
+    return osErrorParameter;
+  }
+
+  MIROS_TaskDelay(delay);
+
+  return osOK;
+}
+
+/*  Timers  */
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument,
+    const osTimerAttr_t *attr) {
+  osTimerAttr_t defaults = { 0 };
+  Os2Timer_t *timer;
+
+  if ((func == NULL) || OS2_IN_ISR()) {
+    return NULL;
+  }
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  timer = OS2_CONTROL_BLOCK(attr, Os2_TimerPool, Os2_TimerUsed);
+  if (timer == NULL) {
+    return NULL;
+  }
+
+  timer->next = NULL;
+  timer->func = func;
+  timer->argument = argument;
+  timer->name = attr->name;
+  timer->type = type;
+  timer->period = 0;
+  timer->remaining = 0;
+  timer->running = 0;
+  timer->pending = 0;
+  timer->linked = 0;
+
+  return timer;
+}
+
+const char* osTimerGetName(osTimerId_t timer_id) {
+  Os2Timer_t *timer = timer_id;
+
+  return (timer == NULL) ? NULL : timer->name;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+  Os2Timer_t *timer = timer_id;
+  uint32_t wake = 0;
+  uint32_t primask;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if ((timer == NULL) || (ticks == 0)) {
+    return osErrorParameter;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  timer->period = ticks;
+  timer->remaining = ticks;
+  timer->running = 1;
+
+  if (!timer->linked) {
+    wake = (Os2_Timers == NULL);
+    timer->next = Os2_Timers;
+    Os2_Timers = timer;
+    timer->linked = 1;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (wake) {
+    MIROS_SemPost(&Os2_TimerWake);
+  }
+
+  return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id) {
+  Os2Timer_t *timer = timer_id;
+  osStatus_t status = osOK;
+  uint32_t primask;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (timer == NULL) {
+    return osErrorParameter;
+  }
+
+  /* unlinked by the timer task */
+  MIROS_CRITICAL_ENTER(primask);
+  if (!timer->running) {
+    status = osErrorResource;
+  }
+  timer->running = 0;
+  timer->pending = 0;
+  MIROS_CRITICAL_EXIT(primask);
+
+  return status;
+}
+
+uint32_t osTimerIsRunning(osTimerId_t timer_id) {
+  Os2Timer_t *timer = timer_id;
+
+  return (timer == NULL) ? 0 : timer->running;
+}
+
+osStatus_t osTimerDelete(osTimerId_t timer_id) {
+  Os2Timer_t *timer = timer_id;
+  Os2Timer_t **link;
+  uint32_t primask;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (timer == NULL) {
+    return osErrorParameter;
+  }
+
+  /* the control block may be reused at once, unlink it now */
+  MIROS_CRITICAL_ENTER(primask);
+  timer->running = 0;
+  timer->pending = 0;
+  for (link = &Os2_Timers; *link != NULL; link = &(*link)->next) {
+    if (*link == timer) {
+      *link = timer->next;
+      break;
+    }
+  }
+  timer->linked = 0;
+  MIROS_CRITICAL_EXIT(primask);
+
+  OS2_POOL_GIVE(Os2_TimerPool, Os2_TimerUsed, timer);
+
+  return osOK;
+}
+
+/*  Event flags  */
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+  osEventFlagsAttr_t defaults = { 0 };
+  Os2EventFlags_t *ef;
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  ef = OS2_CONTROL_BLOCK(attr, Os2_EventFlagsPool, Os2_EventFlagsUsed);
+  if (ef == NULL) {
+    return NULL;
+  }
+
+  MIROS_SemInitialize(&ef->changed, 0);
+  ef->flags = 0;
+  ef->waiters = 0;
+  ef->name = attr->name;
+
+  return ef;
+}
+
+const char* osEventFlagsGetName(osEventFlagsId_t ef_id) {
+  Os2EventFlags_t *ef = ef_id;
+
+  return (ef == NULL) ? NULL : ef->name;
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+  Os2EventFlags_t *ef = ef_id;
+  uint32_t result;
+  uint32_t primask;
+
+  if ((ef == NULL) || (flags & osFlagsError)) {
+    return osFlagsErrorParameter;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  ef->flags |= flags;
+  result = ef->flags;
+
+  /* wake all blocked waiters up, to check their flags again */
+  while (ef->waiters > 0) {
+    ef->waiters--;
+    MIROS_SemPost(&ef->changed);
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return result;
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+  Os2EventFlags_t *ef = ef_id;
+  uint32_t result;
+  uint32_t primask;
+
+  if ((ef == NULL) || (flags & osFlagsError)) {
+    return osFlagsErrorParameter;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  result = ef->flags;
+  ef->flags &= ~flags;
+  MIROS_CRITICAL_EXIT(primask);
+
+  return result;
+}
+
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
+  Os2EventFlags_t *ef = ef_id;
+
+  return (ef == NULL) ? 0 : ef->flags;
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags,
+    uint32_t options, uint32_t timeout) {
+  Os2EventFlags_t *ef = ef_id;
+  uint32_t result = osFlagsErrorResource;
+  uint32_t primask;
+
+  if ((ef == NULL) || (flags == 0) || (flags & osFlagsError)) {
+    return osFlagsErrorParameter;
+  }
+
+  if (OS2_IN_ISR() && (timeout != 0)) {
+    return osFlagsErrorParameter;
+  }
+
+  for (;;) {
+    uint32_t current;
+    uint32_t match;
+
+    MIROS_CRITICAL_ENTER(primask);
+
+    current = ef->flags;
+    if (options & osFlagsWaitAll) {
+      match = ((current & flags) == flags);
+    } else {
+      match = ((current & flags) != 0);
+    }
+
+    if (match) {
+      if (!(options & osFlagsNoClear)) {
+        ef->flags &= ~flags;
+      }
+      MIROS_CRITICAL_EXIT(primask);
+      return current;
+    }
+
+    if (timeout == 0) {
+      MIROS_CRITICAL_EXIT(primask);
+      return result;
+    }
+
+    if (timeout == osWaitForever) {
+      ef->waiters++;
+      MIROS_CRITICAL_EXIT(primask);
+      MIROS_SemWait(&ef->changed);
+    } else {
+      MIROS_CRITICAL_EXIT(primask);
+      MIROS_TaskDelay(1);
+      timeout--;
+      result = osFlagsErrorTimeout;
+    }
+  }
+}
+
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+  Os2EventFlags_t *ef = ef_id;
+
+  if (ef == NULL) {
+    return osErrorParameter;
+  }
+
+  if (ef->changed.head != NULL) {
+    return osErrorResource;
+  }
+
+  OS2_POOL_GIVE(Os2_EventFlagsPool, Os2_EventFlagsUsed, ef);
+
+  return osOK;
+}
+
+/*  Mutexes  */
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+  osMutexAttr_t defaults = { 0 };
+  Os2Mutex_t *mutex;
+
+  if (OS2_IN_ISR()) {
+    return NULL;
+  }
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  mutex = OS2_CONTROL_BLOCK(attr, Os2_MutexPool, Os2_MutexUsed);
+  if (mutex == NULL) {
+    return NULL;
+  }
+
+  MIROS_SemInitialize(&mutex->lock, 1);
+  mutex->owner = NULL;
+  mutex->count = 0;
+  mutex->attr_bits = attr->attr_bits;
+  mutex->name = attr->name;
+
+  return mutex;
+}
+
+const char* osMutexGetName(osMutexId_t mutex_id) {
+  Os2Mutex_t *mutex = mutex_id;
+
+  return (mutex == NULL) ? NULL : mutex->name;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+  Os2Mutex_t *mutex = mutex_id;
+  Task_t *self = MIROS_GetRunningTask();
+  osStatus_t status;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (mutex == NULL) {
+    return osErrorParameter;
+  }
+
+  /* only the owner sets the owner to itself */
+  if (mutex->owner == self) {
+    if (!(mutex->attr_bits & osMutexRecursive)) {
+      return osErrorResource;
+    }
+    mutex->count++;
+    return osOK;
+  }
+
+  status = Os2_SemAcquire(&mutex->lock, timeout);
+  if (status == osOK) {
+    mutex->owner = self;
+    mutex->count = 1;
+  }
+
+  return status;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+  Os2Mutex_t *mutex = mutex_id;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (mutex == NULL) {
+    return osErrorParameter;
+  }
+
+  if (mutex->owner != MIROS_GetRunningTask()) {
+    return osErrorResource;
+  }
+
+  if (--mutex->count > 0) {
+    return osOK;
+  }
+
+  mutex->owner = NULL;
+  MIROS_SemPost(&mutex->lock);
+
+  return osOK;
+}
+
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
+  Os2Mutex_t *mutex = mutex_id;
+
+  return (mutex == NULL) ? NULL : mutex->owner;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+  Os2Mutex_t *mutex = mutex_id;
+
+  if (mutex == NULL) {
+    return osErrorParameter;
+  }
+
+  if ((mutex->owner != NULL) || (mutex->lock.head != NULL)) {
+    return osErrorResource;
+  }
+
+  OS2_POOL_GIVE(Os2_MutexPool, Os2_MutexUsed, mutex);
+
+  return osOK;
+}
+
+/*  Semaphores  */
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count,
+    const osSemaphoreAttr_t *attr) {
+  osSemaphoreAttr_t defaults = { 0 };
+  Os2Semaphore_t *sem;
+
+  if ((max_count == 0) || (initial_count > max_count)) {
+    return NULL;
+  }
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  sem = OS2_CONTROL_BLOCK(attr, Os2_SemaphorePool, Os2_SemaphoreUsed);
+  if (sem == NULL) {
+    return NULL;
+  }
+
+  MIROS_SemInitialize(&sem->sem, initial_count);
+  sem->max_count = max_count;
+  sem->name = attr->name;
+
+  return sem;
+}
+
+const char* osSemaphoreGetName(osSemaphoreId_t semaphore_id) {
+  Os2Semaphore_t *sem = semaphore_id;
+
+  return (sem == NULL) ? NULL : sem->name;
+}
+
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
+  Os2Semaphore_t *sem = semaphore_id;
+
+  if (sem == NULL) {
+    return osErrorParameter;
+  }
+
+  return Os2_SemAcquire(&sem->sem, timeout);
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+  Os2Semaphore_t *sem = semaphore_id;
+  osStatus_t status = osOK;
+  uint32_t primask;
+
+  if (sem == NULL) {
+    return osErrorParameter;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  if (sem->sem.count >= sem->max_count) {
+    status = osErrorResource;
+  } else {
+    MIROS_SemPost(&sem->sem);
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  return status;
+}
+
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
+  Os2Semaphore_t *sem = semaphore_id;
+
+  return (sem == NULL) ? 0 : sem->sem.count;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+  Os2Semaphore_t *sem = semaphore_id;
+
+  if (sem == NULL) {
+    return osErrorParameter;
+  }
+
+  if (sem->sem.head != NULL) {
+    return osErrorResource;
+  }
+
+  OS2_POOL_GIVE(Os2_SemaphorePool, Os2_SemaphoreUsed, sem);
+
+  return osOK;
+}
+
+/*  Memory pools  */
+
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size,
+    const osMemoryPoolAttr_t *attr) {
+  osMemoryPoolAttr_t defaults = { 0 };
+  Os2MemoryPool_t *mp;
+  uint8_t *mem;
+  void **block;
+
+  if ((block_count == 0) || (block_size == 0) || OS2_IN_ISR()) {
+    return NULL;
+  }
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  if ((attr->mp_mem != NULL) && (((uint32_t) attr->mp_mem & 3U)
+      || (attr->mp_size < MIROS_OS2_MP_SIZE(block_count, block_size)))) {
+    return NULL;
+  }
+
+  mp = OS2_CONTROL_BLOCK(attr, Os2_MemoryPoolPool, Os2_MemoryPoolUsed);
+  if (mp == NULL) {
+    return NULL;
+  }
+
+  mem = attr->mp_mem;
+  if (mem == NULL) {
+    mem = Os2_Reserve(MIROS_OS2_MP_SIZE(block_count, block_size));
+  }
+
+  if (mem == NULL) {
+    OS2_POOL_GIVE(Os2_MemoryPoolPool, Os2_MemoryPoolUsed, mp);
+    return NULL;
+  }
+
+  mp->mem = mem;
+  mp->block_size = (block_size + 3U) & ~3U;
+  mp->block_count = block_count;
+  mp->name = attr->name;
+
+  /* link all blocks into the free list, in address order */
+  mp->free_list = NULL;
+  for (uint32_t i = block_count; i > 0; i--) {
+    block = (void**) (mp->mem + ((i - 1) * mp->block_size));
+    *block = mp->free_list;
+    mp->free_list = block;
+  }
+
+  MIROS_SemInitialize(&mp->free, block_count);
+
+  return mp;
+}
+
+const char* osMemoryPoolGetName(osMemoryPoolId_t mp_id) {
+  Os2MemoryPool_t *mp = mp_id;
+
+  return (mp == NULL) ? NULL : mp->name;
+}
+
+void* osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  Os2MemoryPool_t *mp = mp_id;
+  void **block;
+  uint32_t primask;
+
+  if ((mp == NULL) || (Os2_SemAcquire(&mp->free, timeout) != osOK)) {
+    return NULL;
+  }
+
+  /* a free block is reserved, the free list isn't empty */
+  MIROS_CRITICAL_ENTER(primask);
+  block = mp->free_list;
+  mp->free_list = *block;
+  MIROS_CRITICAL_EXIT(primask);
+
+  return block;
+}
+
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+  Os2MemoryPool_t *mp = mp_id;
+  uint32_t offset;
+  uint32_t primask;
+
+  if ((mp == NULL) || (block == NULL)) {
+    return osErrorParameter;
+  }
+
+  offset = (uint32_t) ((uint8_t*) block - mp->mem);
+  if (((uint8_t*) block < mp->mem)
+      || (offset >= (mp->block_count * mp->block_size))
+      || (offset % mp->block_size)) {
+    return osErrorParameter;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  *(void**) block = mp->free_list;
+  mp->free_list = block;
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_SemPost(&mp->free);
+
+  return osOK;
+}
+
+uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id) {
+  Os2MemoryPool_t *mp = mp_id;
+
+  return (mp == NULL) ? 0 : mp->block_count;
+}
+
+uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id) {
+  Os2MemoryPool_t *mp = mp_id;
+
+  return (mp == NULL) ? 0 : mp->block_size;
+}
+
+uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+  Os2MemoryPool_t *mp = mp_id;
+
+  return (mp == NULL) ? 0 : (mp->block_count - mp->free.count);
+}
+
+uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id) {
+  Os2MemoryPool_t *mp = mp_id;
+
+  return (mp == NULL) ? 0 : mp->free.count;
+}
+
+osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id) {
+  Os2MemoryPool_t *mp = mp_id;
+
+  if (mp == NULL) {
+    return osErrorParameter;
+  }
+
+  if (mp->free.head != NULL) {
+    return osErrorResource;
+  }
+
+  OS2_POOL_GIVE(Os2_MemoryPoolPool, Os2_MemoryPoolUsed, mp);
+
+  return osOK;
+}
+
+/*  Message queues  */
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size,
+    const osMessageQueueAttr_t *attr) {
+  osMessageQueueAttr_t defaults = { 0 };
+  Os2MessageQueue_t *mq;
+  uint8_t *buffer;
+
+  if ((msg_count == 0) || (msg_size == 0) || OS2_IN_ISR()) {
+    return NULL;
+  }
+
+  if (attr == NULL) {
+    attr = &defaults;
+  }
+
+  if ((attr->mq_mem != NULL)
+      && (attr->mq_size < MIROS_OS2_MQ_SIZE(msg_count, msg_size))) {
+    return NULL;
+  }
+
+  mq = OS2_CONTROL_BLOCK(attr, Os2_MessageQueuePool, Os2_MessageQueueUsed);
+  if (mq == NULL) {
+    return NULL;
+  }
+
+  buffer = attr->mq_mem;
+  if (buffer == NULL) {
+    buffer = Os2_Reserve(MIROS_OS2_MQ_SIZE(msg_count, msg_size));
+  }
+
+  if (buffer == NULL) {
+    OS2_POOL_GIVE(Os2_MessageQueuePool, Os2_MessageQueueUsed, mq);
+    return NULL;
+  }
+
+  MIROS_SemInitialize(&mq->slots, msg_count);
+  MIROS_SemInitialize(&mq->messages, 0);
+  mq->buffer = buffer;
+  mq->msg_size = msg_size;
+  mq->msg_count = msg_count;
+  mq->head = 0;
+  mq->tail = 0;
+  mq->name = attr->name;
+
+  return mq;
+}
+
+const char* osMessageQueueGetName(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+
+  return (mq == NULL) ? NULL : mq->name;
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr,
+    uint8_t msg_prio, uint32_t timeout) {
+  Os2MessageQueue_t *mq = mq_id;
+  osStatus_t status;
+  uint32_t primask;
+
+  (void) msg_prio;
+
+  if ((mq == NULL) || (msg_ptr == NULL)) {
+    return osErrorParameter;
+  }
+
+  status = Os2_SemAcquire(&mq->slots, timeout);
+  if (status != osOK) {
+    return status;
+  }
+
+  /* copy in the critical section, so messages are queued in order */
+  MIROS_CRITICAL_ENTER(primask);
+  memcpy(mq->buffer + (mq->tail * mq->msg_size), msg_ptr, mq->msg_size);
+  if (++mq->tail == mq->msg_count) {
+    mq->tail = 0;
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_SemPost(&mq->messages);
+
+  return osOK;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr,
+    uint8_t *msg_prio, uint32_t timeout) {
+  Os2MessageQueue_t *mq = mq_id;
+  osStatus_t status;
+  uint32_t primask;
+
+  if ((mq == NULL) || (msg_ptr == NULL)) {
+    return osErrorParameter;
+  }
+
+  status = Os2_SemAcquire(&mq->messages, timeout);
+  if (status != osOK) {
+    return status;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  memcpy(msg_ptr, mq->buffer + (mq->head * mq->msg_size), mq->msg_size);
+  if (++mq->head == mq->msg_count) {
+    mq->head = 0;
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (msg_prio != NULL) {
+    *msg_prio = 0;
+  }
+
+  MIROS_SemPost(&mq->slots);
+
+  return osOK;
+}
+
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+
+  return (mq == NULL) ? 0 : mq->msg_count;
+}
+
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+
+  return (mq == NULL) ? 0 : mq->msg_size;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+
+  return (mq == NULL) ? 0 : mq->messages.count;
+}
+
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+
+  return (mq == NULL) ? 0 : mq->slots.count;
+}
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+  uint32_t primask;
+
+  if (OS2_IN_ISR()) {
+    return osErrorISR;
+  }
+
+  if (mq == NULL) {
+    return osErrorParameter;
+  }
+
+  /* drop queued messages, unblocking senders waiting for a free slot */
+  while (MIROS_SemTryWait(&mq->messages)) {
+    MIROS_CRITICAL_ENTER(primask);
+    if (++mq->head == mq->msg_count) {
+      mq->head = 0;
+    }
+    MIROS_CRITICAL_EXIT(primask);
+
+    MIROS_SemPost(&mq->slots);
+  }
+
+  return osOK;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+  Os2MessageQueue_t *mq = mq_id;
+
+  if (mq == NULL) {
+    return osErrorParameter;
+  }
+
+  if ((mq->slots.head != NULL) || (mq->messages.head != NULL)) {
+    return osErrorResource;
+  }
+
+  OS2_POOL_GIVE(Os2_MessageQueuePool, Os2_MessageQueueUsed, mq);
+
+  return osOK;
+}
+
+/*  Overhead measurement  */
+
+void MIROS_Os2Measure(Os2Overhead_t *overhead) {
+  static Os2Semaphore_t sem_cb;
+  static Os2Mutex_t mutex_cb;
+  static Os2EventFlags_t ef_cb;
+  static Os2MemoryPool_t mp_cb;
+  static uint32_t mp_mem[1];
+  static Os2MessageQueue_t mq_cb;
+  static uint32_t mq_mem[1];
+  const osSemaphoreAttr_t sem_attr = {
+    .cb_mem = &sem_cb, .cb_size = sizeof(sem_cb)
+  };
+  const osMutexAttr_t mutex_attr = {
+    .cb_mem = &mutex_cb, .cb_size = sizeof(mutex_cb)
+  };
+  const osEventFlagsAttr_t ef_attr = {
+    .cb_mem = &ef_cb, .cb_size = sizeof(ef_cb)
+  };
+  const osMemoryPoolAttr_t mp_attr = {
+    .cb_mem = &mp_cb, .cb_size = sizeof(mp_cb),
+    .mp_mem = mp_mem, .mp_size = sizeof(mp_mem)
+  };
+  const osMessageQueueAttr_t mq_attr = {
+    .cb_mem = &mq_cb, .cb_size = sizeof(mq_cb),
+    .mq_mem = mq_mem, .mq_size = sizeof(mq_mem)
+  };
+  osSemaphoreId_t sem = osSemaphoreNew(1, 0, &sem_attr);
+  osMutexId_t mutex = osMutexNew(&mutex_attr);
+  osEventFlagsId_t ef = osEventFlagsNew(&ef_attr);
+  osMemoryPoolId_t mp = osMemoryPoolNew(1, sizeof(uint32_t), &mp_attr);
+  osMessageQueueId_t mq = osMessageQueueNew(1, sizeof(uint32_t), &mq_attr);
+  uint32_t msg = 0;
+  uint32_t start;
+  void *block;
+
+  start = DWT->CYCCNT;
+  MIROS_SemPost(&sem_cb.sem);
+  (void) MIROS_SemTryWait(&sem_cb.sem);
+  overhead->sem_native = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  (void) osSemaphoreRelease(sem);
+  (void) osSemaphoreAcquire(sem, 0);
+  overhead->sem_os2 = DWT->CYCCNT - start;
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+  static Mutex_t native_mutex;
+
+  MIROS_MutexInitialize(&native_mutex, MIROS_GetRunningTask()->priority);
+
+  start = DWT->CYCCNT;
+  MIROS_MutexLock(&native_mutex);
+  MIROS_MutexUnlock(&native_mutex);
+  overhead->mutex_native = DWT->CYCCNT - start;
+#else
+  overhead->mutex_native = 0;
+#endif
+
+  start = DWT->CYCCNT;
+  (void) osMutexAcquire(mutex, 0);
+  (void) osMutexRelease(mutex);
+  overhead->mutex_os2 = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  (void) osEventFlagsSet(ef, 1U);
+  (void) osEventFlagsWait(ef, 1U, osFlagsWaitAny, 0);
+  overhead->flags_os2 = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  block = osMemoryPoolAlloc(mp, 0);
+  (void) osMemoryPoolFree(mp, block);
+  overhead->pool_os2 = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  (void) osMessageQueuePut(mq, &msg, 0, 0);
+  (void) osMessageQueueGet(mq, &msg, NULL, 0);
+  overhead->queue_os2 = DWT->CYCCNT - start;
+}
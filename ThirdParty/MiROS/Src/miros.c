@@ -29,7 +29,31 @@
 #include <stddef.h>
 #include "stm32f1xx_hal.h"
 #include "miros.h"
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+#include "priority.h"
+#else
 #include "round_robin.h"
+#endif
+#if MIROS_TRACE_ENABLE
+#include "miros_trace.h"
+#endif
+#if MIROS_SERVER_ENABLE
+#include "miros_server.h"
+#endif
+#if MIROS_PARTITION_ENABLE
+#include "miros_partition.h"
+#endif
+#if MIROS_MLFQ_ENABLE
+#include "miros_mlfq.h"
+#endif
+#if MIROS_TIMER_ENABLE
+#include "miros_timer.h"
+#endif
+#include "miros_sem.h"
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+#include "miros_mutex.h"
+#endif
+#include "miros_syscall.h"
 
 /**
  * @brief Stack addresses (start and end) alignment
@@ -45,13 +69,13 @@
  * The start of the memory block is also aligned to the current address,
  * or the next aligned address.
  * */
-#define MIROS_STACK_ALIGNMENT       8
 #define MIROS_STACK_ALIGN_MASK      ((uint32_t)~(MIROS_STACK_ALIGNMENT - 1))
 
 /**
- * @brief Default return from interrupt code (return to thread mode w/ MSP)
+ * @brief Default return from interrupt code (return to thread mode w/ PSP),
+ * tasks run on PSP, MSP is only used by exception handlers
  * */
-#define MIROS_EXCEPTION_RETURN      0xFFFFFFF9
+#define MIROS_EXCEPTION_RETURN      0xFFFFFFFD
 
 /**
  * @brief Default value to be pre-loaded into PSR
@@ -71,6 +95,40 @@ static Task_t Miros_IdleTask = { 0 };
 static Task_t *Miros_RunningTask = NULL;
 static Task_t *Miros_NextTask = NULL;
 
+/**
+ * @brief All added tasks, indexed by task id. Used by the tick to update
+ * delayed tasks, independently of the scheduling algorithm.
+ * */
+static Task_t *Miros_Tasks[MIROS_NUM_TASKS] = { 0 };
+static uint32_t Miros_NumTasks = 0;
+
+static uint32_t Miros_SwitchCount = 0;
+
+/**
+ * @brief System's criticality mode
+ * */
+static uint32_t Miros_Criticality = MIROS_CRITICALITY_LO;
+
+#if MIROS_BUDGET_ENFORCEMENT
+/**
+ * @brief DWT cycle count when the running task was last charged
+ * */
+static uint32_t Miros_ChargeStart = 0;
+#endif
+
+#if MIROS_ADMISSION_CONTROL
+/**
+ * @brief Liu & Layland utilization bound `n * (2^(1/n) - 1)` for n = 1 to
+ * #MIROS_NUM_TASKS periodic tasks, in Q16 fixed point
+ * */
+static const uint32_t Miros_UtilizationBound[MIROS_NUM_TASKS] = {
+  65536, 54291, 51102, 49599, 48725, 48154, 47751, 47452,
+  47221, 47037, 46887, 46763, 46658, 46569, 46492, 46424,
+  46364, 46312, 46264, 46222, 46184, 46149, 46117, 46088,
+  46061, 46037, 46014, 45993, 45973, 45954, 45937, 45921,
+};
+#endif
+
 /**
  * @brief aligns ask's stack start address, end address to
  * #MIROS_STACK_ALIGNMENT bytes (8). And modifies stack size
@@ -129,15 +187,16 @@ static void Miros_PrepareStack(Task_t *task) {
   *(--sp) = 0x02011020; /* R2  */
   *(--sp) = 0x01011010; /* R1  */
   *(--sp) = 0xDEADB00F; /* R0  */
-  --sp;
-  *(sp) = (uint32_t) sp + 1; /* R7 */
-  *(--sp) = 0xDEADB44F; /* R4  */
-  *(--sp) = 0xDEADB55F; /* R5  */
-  *(--sp) = 0xDEADB66F; /* R6  */
-  *(--sp) = 0xDEADB88F; /* R8  */
-  *(--sp) = 0xDEADB99F; /* R9  */
-  *(--sp) = 0xDEADBAAF; /* R10 */
+
+  /* R4 - R11, saved and restored by the context switch (R4 at the lowest) */
   *(--sp) = 0xDEADBBBF; /* R11 */
+  *(--sp) = 0xDEADBAAF; /* R10 */
+  *(--sp) = 0xDEADB99F; /* R9  */
+  *(--sp) = 0xDEADB88F; /* R8  */
+  *(--sp) = 0xDEADB77F; /* R7  */
+  *(--sp) = 0xDEADB66F; /* R6  */
+  *(--sp) = 0xDEADB55F; /* R5  */
+  *(--sp) = 0xDEADB44F; /* R4  */
 
   /* pre-fill the rest of the stack with a pre-defined pattern (helps to visualize stack usage) */
   for (uint32_t *mem = sp; mem > stack;) {
@@ -148,17 +207,333 @@ static void Miros_PrepareStack(Task_t *task) {
   task->stack_ptr = (uint32_t) sp;
 }
 
+/**
+ * @brief Get task's WCET in a criticality mode
+ *
+ * @param [in] task pointer to a periodic task
+ * @param [in] mode criticality mode
+ *
+ * @return uint32_t: task's WCET in microseconds
+ * */
+MIROS_RAMFUNC static uint32_t Miros_Wcet(const Task_t *task, uint32_t mode) {
+  if ((mode == MIROS_CRITICALITY_HI)
+      && (task->criticality == MIROS_CRITICALITY_HI)) {
+    return task->wcet_hi;
+  }
+
+  return task->wcet;
+}
+
+#if MIROS_ADMISSION_CONTROL
+/**
+ * @brief Get task's period in microseconds
+ *
+ * @param [in] task pointer to a periodic task
+ *
+ * @return uint64_t: task's period in microseconds
+ * */
+static uint64_t Miros_PeriodUs(const Task_t *task) {
+  return (uint64_t) task->period * HAL_GetTickFreq() * 1000U;
+}
+
+/**
+ * @brief Exact response time analysis of a periodic task, the response time
+ * is the task's WCET plus the interference of the tasks of higher (or the
+ * same) priority: R = C + sum(ceil(R / Tj) * Cj), iterated until it
+ * converges, or exceeds the task's period.
+ *
+ * @param [in] tasks periodic task set
+ * @param [in] num_tasks number of tasks in @p tasks
+ * @param [in] task the analyzed task, one of @p tasks
+ * @param [in] mode criticality mode, selects the tasks' WCETs
+ *
+ * @return uint32_t: 1 if the task's response time is within its period,
+ *    0 otherwise
+ * */
+static uint32_t Miros_MeetsDeadline(const Task_t **tasks, uint32_t num_tasks,
+    const Task_t *task, uint32_t mode) {
+  uint64_t deadline = Miros_PeriodUs(task);
+  uint64_t response = Miros_Wcet(task, mode);
+  uint64_t previous = 0;
+
+  while ((response != previous) && (response <= deadline)) {
+    previous = response;
+    response = Miros_Wcet(task, mode);
+
+    for (uint32_t index = 0; index < num_tasks; index++) {
+      const Task_t *other = tasks[index];
+      uint64_t period = Miros_PeriodUs(other);
+
+      if ((other != task) && (other->priority >= task->priority)) {
+        response += ((previous + period - 1) / period)
+            * Miros_Wcet(other, mode);
+      }
+    }
+  }
+
+  return (response <= deadline);
+}
+
+/**
+ * @brief Admission control, checks whether the periodic task set stays
+ * schedulable in a criticality mode after adding @p candidate
+ *
+ * @param [in] candidate pointer to the task to be added
+ * @param [in] mode criticality mode, only high criticality tasks are
+ *    accounted for in high criticality mode
+ *
+ * @return uint32_t: 1 if @p candidate can be added, 0 otherwise
+ * */
+static uint32_t Miros_AdmitMode(const Task_t *candidate, uint32_t mode) {
+  const Task_t *tasks[MIROS_NUM_TASKS];
+  uint32_t num_tasks = 0;
+  uint64_t utilization = 0;
+  uint32_t rate_monotonic = 1;
+
+  if ((candidate->period == 0) || (candidate->criticality < mode)) {
+    return 1;
+  }
+
+  /* periodic task set, including the candidate */
+  for (uint32_t id = 0; id < Miros_NumTasks; id++) {
+    if ((Miros_Tasks[id]->period > 0)
+        && (Miros_Tasks[id]->criticality >= mode)) {
+      tasks[num_tasks++] = Miros_Tasks[id];
+    }
+  }
+  tasks[num_tasks++] = candidate;
+
+  for (uint32_t index = 0; index < num_tasks; index++) {
+    const Task_t *task = tasks[index];
+    uint64_t period = Miros_PeriodUs(task);
+
+    /* utilization, in Q16, rounded up */
+    utilization += (((uint64_t) Miros_Wcet(task, mode) << 16) + period - 1)
+        / period;
+
+    /* shorter periods must have higher priorities */
+    for (uint32_t other = 0; other < num_tasks; other++) {
+      if ((tasks[other]->period < task->period)
+          && (tasks[other]->priority <= task->priority)) {
+        rate_monotonic = 0;
+      }
+    }
+  }
+
+  if (utilization > (1UL << 16)) {
+    return 0;
+  }
+
+  /* sufficient test */
+  if (rate_monotonic
+      && (utilization <= Miros_UtilizationBound[num_tasks - 1])) {
+    return 1;
+  }
+
+  /* exact test */
+  for (uint32_t index = 0; index < num_tasks; index++) {
+    if (!Miros_MeetsDeadline(tasks, num_tasks, tasks[index], mode)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/**
+ * @brief Admission control, checks whether the periodic task set stays
+ * schedulable after adding @p candidate, in all criticality modes
+ *
+ * @param [in] candidate pointer to the task to be added
+ *
+ * @return uint32_t: 1 if @p candidate can be added, 0 otherwise
+ * */
+static uint32_t Miros_Admit(const Task_t *candidate) {
+#if MIROS_MIXED_CRITICALITY
+  if (!Miros_AdmitMode(candidate, MIROS_CRITICALITY_HI)) {
+    return 0;
+  }
+#endif
+
+  return Miros_AdmitMode(candidate, MIROS_CRITICALITY_LO);
+}
+#endif
+
+/**
+ * @brief Get task's execution budget in CPU cycles
+ *
+ * @param [in] task pointer to a periodic task
+ *
+ * @return uint32_t: task's budget (WCET) in CPU cycles
+ * */
+MIROS_RAMFUNC static uint32_t Miros_BudgetCycles(const Task_t *task) {
+  return Miros_Wcet(task, Miros_Criticality) * (SystemCoreClock / 1000000U);
+}
+
+#if MIROS_MIXED_CRITICALITY
+/**
+ * @brief Switch the system's criticality mode. In high criticality mode, low
+ * criticality tasks are dropped, and high criticality tasks get the rest of
+ * their high criticality budgets.
+ *
+ * @pre Called with interrupts disabled
+ *
+ * @param [in] mode new criticality mode
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Miros_SetCriticality(uint32_t mode) {
+  uint32_t dropped = 0;
+
+  Miros_Criticality = mode;
+
+  for (uint32_t id = 0; id < Miros_NumTasks; id++) {
+    Task_t *task = Miros_Tasks[id];
+
+    if (task->criticality == MIROS_CRITICALITY_LO) {
+      dropped |= (1UL << id);
+    } else if ((mode == MIROS_CRITICALITY_HI) && (task->period > 0)) {
+      task->budget += (task->wcet_hi - task->wcet)
+          * (SystemCoreClock / 1000000U);
+    }
+  }
+
+  Scheduler_SetDroppedTasks((mode == MIROS_CRITICALITY_HI) ? dropped : 0);
+
+#if MIROS_TRACE_ENABLE
+  MIROS_TraceRecord(MIROS_TRACE_MODE, mode);
+#endif
+}
+#endif
+
+#if MIROS_BUDGET_ENFORCEMENT
+/**
+ * @brief Charge the running task for the CPU cycles it used since it was
+ * last charged. A periodic task that exhausts its budget is suspended
+ * until its next period.
+ *
+ * @pre Called with interrupts disabled
+ *
+ * @param void
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Miros_ChargeRunningTask(void) {
+  Task_t *task = Miros_RunningTask;
+  uint32_t now = DWT->CYCCNT;
+  uint32_t used = now - Miros_ChargeStart;
+
+  Miros_ChargeStart = now;
+
+#if MIROS_FAIR_SHARE
+  if ((task != NULL) && (task->id < MIROS_NUM_TASKS)
+      && (task->priority == MIROS_FAIR_PRIORITY)) {
+    /* clamped, so the product fits in 32 bits (hardware division) */
+    uint32_t cycles = (used > (UINT32_MAX / MIROS_FAIR_WEIGHT)) ?
+        (UINT32_MAX / MIROS_FAIR_WEIGHT) : used;
+
+    task->vruntime += (cycles * MIROS_FAIR_WEIGHT) / task->weight;
+  }
+#endif
+
+#if MIROS_SERVER_ENABLE
+  if ((task != NULL) && (task->server != NULL)) {
+    MIROS_ServerCharge(task->server, used);
+    return;
+  }
+#endif
+
+  if ((task == NULL) || (task->period == 0)) {
+    return;
+  }
+
+  if (used < task->budget) {
+    task->budget -= used;
+    return;
+  }
+
+#if MIROS_MIXED_CRITICALITY
+  /* high criticality task exhausted its low criticality budget */
+  if ((task->criticality == MIROS_CRITICALITY_HI)
+      && (Miros_Criticality == MIROS_CRITICALITY_LO)) {
+    used -= task->budget;
+    task->budget = 0;
+    Miros_SetCriticality(MIROS_CRITICALITY_HI);
+
+    if (used < task->budget) {
+      task->budget -= used;
+      return;
+    }
+  }
+#endif
+
+  /* budget exhausted, count the overrun once per period */
+  if (task->budget > 0) {
+    task->budget = 0;
+    task->overruns++;
+#if MIROS_TRACE_ENABLE
+    MIROS_TraceRecord(MIROS_TRACE_OVERRUN, task->id);
+#endif
+    MIROS_TaskOverrunCallback(task);
+  }
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+  /**
+   * Suspending the task would leave the system ceiling raised by its
+   * mutexes. It's suspended once it unlocks them all, as unlocking calls the
+   * scheduler, which charges it again.
+   * */
+  if (MIROS_MutexHeld(task)) {
+    return;
+  }
+#endif
+
+  if (task->state == MIROS_TASK_READY) {
+    task->state = MIROS_TASK_SUSPENDED;
+    Scheduler_BlockTask(task);
+  }
+}
+#endif
+
 void MIROS_Initialize(TaskHandle_t idle_handle, uint32_t *idle_stack,
     uint32_t stack_size) {
 
   /*  initialize task scheduler  */
   Miros_RunningTask = NULL;
   Miros_NextTask = NULL;
+  Miros_NumTasks = 0;
+  Miros_SwitchCount = 0;
+  Miros_Criticality = MIROS_CRITICALITY_LO;
 
   /* initialize Idle task */
   Miros_IdleTask.handle = idle_handle;
   Miros_IdleTask.stack = idle_stack;
   Miros_IdleTask.stack_size = stack_size;
+  Miros_IdleTask.state = MIROS_TASK_READY;
+  Miros_IdleTask.next = NULL;
+  Miros_IdleTask.timeout = 0;
+  Miros_IdleTask.id = MIROS_NUM_TASKS;
+  Miros_IdleTask.priority = 0;
+  Miros_IdleTask.threshold = 0;
+  Miros_IdleTask.period = 0;
+  Miros_IdleTask.wcet = 0;
+  Miros_IdleTask.release = 0;
+  Miros_IdleTask.budget = 0;
+  Miros_IdleTask.overruns = 0;
+  Miros_IdleTask.server = NULL;
+  Miros_IdleTask.criticality = MIROS_CRITICALITY_LO;
+  Miros_IdleTask.wcet_hi = 0;
+  Miros_IdleTask.weight = MIROS_FAIR_WEIGHT;
+  Miros_IdleTask.vruntime = 0;
+  Miros_IdleTask.control = 0;
+
+#if MIROS_BUDGET_ENFORCEMENT
+  /* start DWT cycle counter */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  Miros_ChargeStart = 0;
+#endif
 
   Miros_AlignStack(&Miros_IdleTask);
   Miros_PrepareStack(&Miros_IdleTask);
@@ -168,54 +543,377 @@ void MIROS_Initialize(TaskHandle_t idle_handle, uint32_t *idle_stack,
 
 void MIROS_TaskInitialize(Task_t *task, TaskHandle_t handle, uint32_t *stack,
     uint32_t stack_size) {
+  HAL_StatusTypeDef status;
+
+  status = MIROS_TaskInitializeWithAttributes(task, handle, stack, stack_size,
+      NULL);
+
+  /* tasks without attributes are only rejected when the task table is full */
+  assert_param(status == HAL_OK);
+  (void) status;
+}
+
+HAL_StatusTypeDef MIROS_TaskInitializeWithAttributes(Task_t *task,
+    TaskHandle_t handle, uint32_t *stack, uint32_t stack_size,
+    const TaskAttributes_t *attributes) {
+  uint32_t primask;
 
   task->handle = handle;
   task->stack = stack;
   task->stack_size = stack_size;
+  task->state = MIROS_TASK_READY;
+  task->next = NULL;
+  task->timeout = 0;
+  task->priority = MIROS_DEFAULT_PRIORITY;
+  task->threshold = MIROS_DEFAULT_PRIORITY;
+  task->period = 0;
+  task->wcet = 0;
+  task->criticality = MIROS_CRITICALITY_LO;
+  task->wcet_hi = 0;
+  task->weight = MIROS_FAIR_WEIGHT;
+  task->vruntime = 0;
+  task->control = 0;
+
+  if (attributes != NULL) {
+    assert_param(attributes->priority < MIROS_NUM_PRIORITIES);
+    assert_param(attributes->threshold < MIROS_NUM_PRIORITIES);
+    task->priority = attributes->priority;
+    task->threshold = attributes->priority;
+    if (attributes->threshold > attributes->priority) {
+      task->threshold = attributes->threshold;
+    }
+
+    assert_param((attributes->period == 0) || (attributes->wcet > 0));
+    task->period = attributes->period;
+    task->wcet = attributes->wcet;
+
+    assert_param(attributes->criticality <= MIROS_CRITICALITY_HI);
+    task->criticality = attributes->criticality;
+    task->wcet_hi = attributes->wcet;
+    if (attributes->wcet_hi > attributes->wcet) {
+      task->wcet_hi = attributes->wcet_hi;
+    }
+
+    if (attributes->weight > 0) {
+      task->weight = attributes->weight;
+    }
+
+    if (attributes->unprivileged) {
+      task->control = CONTROL_nPRIV_Msk;
+    }
+  }
+
+  task->release = task->period;
+  task->budget = Miros_BudgetCycles(task);
+  task->overruns = 0;
+  task->server = NULL;
+
+#if MIROS_ADMISSION_CONTROL
+  if (!Miros_Admit(task)) {
+    return HAL_ERROR;
+  }
+#endif
+
+  /* tasks may be created at run time, by several tasks */
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (Miros_NumTasks >= MIROS_NUM_TASKS) {
+    MIROS_CRITICAL_EXIT(primask);
+    return HAL_ERROR;
+  }
+
+  task->id = Miros_NumTasks;
+  Miros_Tasks[Miros_NumTasks] = task;
+  Miros_NumTasks++;
+
+  MIROS_CRITICAL_EXIT(primask);
 
   Miros_AlignStack(task);
   Miros_PrepareStack(task);
 
   /* add task from task queue & update number of added tasks */
   Scheduler_AddTask(task);
+
+  return HAL_OK;
+}
+
+void MIROS_Start(void) {
+  /* only SVC (priority 0) may preempt, until the first task is running */
+  __set_BASEPRI(1UL << (8U - __NVIC_PRIO_BITS));
+
+  NVIC_SetPriority(SVCall_IRQn, MIROS_SVC_PRIORITY);
+  NVIC_SetPriority(PendSV_IRQn, MIROS_PENDSV_PRIORITY);
+  NVIC_SetPriority(SysTick_IRQn, MIROS_SYSTICK_PRIORITY);
+
+  /**
+   * Budgets were converted to CPU cycles when tasks (and servers) were
+   * initialized, which may be before the system clock was configured.
+   * Convert them again, at the final SystemCoreClock.
+   * */
+  for (uint32_t id = 0; id < Miros_NumTasks; id++) {
+    Miros_Tasks[id]->budget = Miros_BudgetCycles(Miros_Tasks[id]);
+  }
+#if MIROS_SERVER_ENABLE
+  MIROS_ServerStart();
+#endif
+
+  Miros_NextTask = Scheduler_GetTask();
+  if (Miros_NextTask == NULL) {
+    Miros_NextTask = &Miros_IdleTask;
+  }
+
+  /**
+   * Reset MSP to the top of RAM, discarding main()'s stack frames. Nothing
+   * uses the stack after this point, SVC stacks its frame on the new MSP.
+   * */
+  __asm volatile (
+      "LDR  R0, =_estack\n\t"
+      "MSR  MSP, R0\n\t"
+      "ISB\n\t"
+      "CPSIE I\n\t"
+      "SVC  %0\n\t"
+      :
+      : "i" (MIROS_SYSCALL_START)
+      : "r0", "memory"
+  );
+
+  /* not reachable, the first task never returns to main() */
+  for (;;) {
+  }
+}
+
+void MIROS_Launch(void) {
+  Task_t *task = Miros_NextTask;
+
+  if ((Miros_RunningTask != NULL) || (task == NULL)) {
+    return;
+  }
+
+  Miros_RunningTask = task;
+  Miros_SwitchCount++;
+#if MIROS_TRACE_ENABLE
+  MIROS_TraceRecord(MIROS_TRACE_SWITCH, task->id);
+#endif
+#if MIROS_BUDGET_ENFORCEMENT
+  Miros_ChargeStart = DWT->CYCCNT;
+#endif
+
+  __set_CONTROL(task->control);
+  __set_BASEPRI(0);
+
+  /**
+   * Same as PendSV's switch in: load the task's saved registers (R4 - R11)
+   * and PSP, then return to thread mode on PSP with the task's exception
+   * frame (R0 - R3, R12, LR, PC, PSR). MSP is reset to the top of RAM,
+   * discarding the SVC handler's frames, it's only used by handlers from
+   * now on.
+   * */
+  __asm volatile (
+      "MOV    R0, %0\n\t"
+      "MOV    LR, %1\n\t"
+      "LDMIA  R0!, {R4-R11}\n\t"
+      "MSR    PSP, R0\n\t"
+      "LDR    R1, =_estack\n\t"
+      "MSR    MSP, R1\n\t"
+      "ISB\n\t"
+      "BX     LR\n\t"
+      :
+      : "r" (task->stack_ptr), "r" (MIROS_EXCEPTION_RETURN)
+      : "r0", "r1", "memory"
+  );
 }
 
-void MIROS_Sched(void) {
-  /* get task from task queue */
+MIROS_RAMFUNC void MIROS_Sched(void) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  /* not started yet, the first task is launched by MIROS_Start() */
+  if (Miros_RunningTask == NULL) {
+    MIROS_CRITICAL_EXIT(primask);
+    return;
+  }
+
+#if MIROS_BUDGET_ENFORCEMENT
+  Miros_ChargeRunningTask();
+#endif
+
+  /* get task from task queue, or run idle task if no task is ready */
   Miros_NextTask = Scheduler_GetTask();
 
+#if MIROS_MIXED_CRITICALITY
+  /* idle instant, back to low criticality mode */
+  if ((Miros_NextTask == NULL)
+      && (Miros_Criticality == MIROS_CRITICALITY_HI)) {
+    Miros_SetCriticality(MIROS_CRITICALITY_LO);
+    Miros_NextTask = Scheduler_GetTask();
+  }
+#endif
+
+  if (Miros_NextTask == NULL) {
+    Miros_NextTask = &Miros_IdleTask;
+  }
+
   MIROS_PEND_SVCall();
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+uint32_t MIROS_GetSwitchCount(void) {
+  return Miros_SwitchCount;
 }
 
-void HAL_SYSTICK_Callback(void) {
+uint32_t MIROS_GetCriticality(void) {
+  return Miros_Criticality;
+}
+
+MIROS_RAMFUNC Task_t* MIROS_GetRunningTask(void) {
+  return Miros_RunningTask;
+}
+
+MIROS_RAMFUNC void MIROS_TaskBlock(void) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  assert_param(Miros_RunningTask != NULL);
+  assert_param(Miros_RunningTask != &Miros_IdleTask);
+
+#if MIROS_MLFQ_ENABLE
+  MIROS_MlfqBlock(Miros_RunningTask);
+#endif
+
+  Miros_RunningTask->state = MIROS_TASK_BLOCKED;
+  Scheduler_BlockTask(Miros_RunningTask);
+#if MIROS_TRACE_ENABLE
+  MIROS_TraceRecord(MIROS_TRACE_BLOCK, Miros_RunningTask->id);
+#endif
+  MIROS_Sched();
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+MIROS_RAMFUNC void MIROS_TaskUnblock(Task_t *task) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  task->state = MIROS_TASK_READY;
+#if MIROS_TRACE_ENABLE
+  MIROS_TraceRecord(MIROS_TRACE_UNBLOCK, task->id);
+#endif
+
+  /* preempt the running task, if the scheduler requires it */
+  if (Scheduler_ReadyTask(task)) {
+    MIROS_Sched();
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+void MIROS_TaskDelay(uint32_t ticks) {
+  uint32_t primask;
+
+  if (ticks == 0) {
+    return;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  Miros_RunningTask->timeout = ticks;
+  MIROS_TaskBlock();
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+void MIROS_TaskWaitPeriod(void) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  assert_param(Miros_RunningTask->period > 0);
+  MIROS_TaskDelay(Miros_RunningTask->release);
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+__weak void MIROS_TaskOverrunCallback(Task_t *task) {
+  (void) task;
+}
+
+MIROS_RAMFUNC void MIROS_Tick(void) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  for (uint32_t id = 0; id < Miros_NumTasks; id++) {
+    Task_t *task = Miros_Tasks[id];
+
+    /* start periodic tasks' next period, with a full budget */
+    if (task->period > 0) {
+      task->release--;
+      if (task->release == 0) {
+        task->release = task->period;
+        task->budget = Miros_BudgetCycles(task);
+        if (task->state == MIROS_TASK_SUSPENDED) {
+          MIROS_TaskUnblock(task);
+        }
+      }
+    }
+
+    /* unblock delayed tasks, whose timeout expired */
+    if (task->timeout > 0) {
+      task->timeout--;
+      if (task->timeout == 0) {
+        MIROS_TaskUnblock(task);
+      }
+    }
+  }
+
+#if MIROS_SERVER_ENABLE
+  MIROS_ServerTick();
+#endif
+
+#if MIROS_PARTITION_ENABLE
+  MIROS_PartitionTick();
+#endif
+
+#if MIROS_MLFQ_ENABLE
+  MIROS_MlfqTick();
+#endif
+
+#if MIROS_TIMER_ENABLE
+  MIROS_TimerTick();
+#endif
+
+  Scheduler_Tick();
+
+  MIROS_CRITICAL_EXIT(primask);
+
   MIROS_Sched();
 }
 
-void PendSV_Handler(void) {
-  /* switch out current task */
+MIROS_RAMFUNC void HAL_SYSTICK_Callback(void) {
+  MIROS_Tick();
+}
+
+/**
+ * @brief Switch the running task's context out, and the next task's in.
+ * Called by PendSV, after the running task's registers are saved on its
+ * stack.
+ *
+ * @param [in] sp running task's stack pointer (PSP)
+ *
+ * @return uint32_t: stack pointer of the task to switch in
+ * */
+MIROS_RAMFUNC __attribute__((used)) static uint32_t Miros_Switch(uint32_t sp) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
 
   if (Miros_RunningTask != NULL) {
-    // save GPR registers
-    __asm(
-        "PUSH {R4}\n\t"
-        "PUSH {R5}\n\t"
-        "PUSH {R6}\n\t"
-        "PUSH {R8}\n\t"
-        "PUSH {R9}\n\t"
-        "PUSH {R10}\n\t"
-        "PUSH {R11}\n\t"
-    );
-
-    // save SP
-    __asm (
-        "MOV  R3, %0\n\t"
-        "STR  SP, [R3, #8]\n\t"
-        :
-        : "r" (Miros_RunningTask)
-    );
-  }
-
-  /* switch in next task */
+    Miros_RunningTask->stack_ptr = sp;
+  }
 
   /**
    * If at least 1 task is added, Miros_NextTask will never be NULL.
@@ -223,47 +921,41 @@ void PendSV_Handler(void) {
    * against accessing a NULL pointer.
    * */
   if (Miros_NextTask != NULL) {
+    /* several scheduler calls may pend one switch, count switches here */
+    if (Miros_NextTask != Miros_RunningTask) {
+      Miros_SwitchCount++;
+#if MIROS_TRACE_ENABLE
+      MIROS_TraceRecord(MIROS_TRACE_SWITCH, Miros_NextTask->id);
+#endif
+    }
+
     Miros_RunningTask = Miros_NextTask;
+    sp = Miros_RunningTask->stack_ptr;
 
-    // load SP
-    __asm (
-        "MOV R3, %0\n\t"
-        "LDR SP, [R3, #8]\n\t"
-        :
-        : "r" (Miros_NextTask)
-    );
-
-    // load GPR registers
-    __asm(
-        "POP {R11}\n\t"
-        "POP {R10}\n\t"
-        "POP {R9}\n\t"
-        "POP {R8}\n\t"
-        "POP {R6}\n\t"
-        "POP {R5}\n\t"
-        "POP {R4}\n\t"
-    );
-
-    // load R7
-    /**
-     * This step is necessary for GNU ARM GCC, as it uses R7 as a pointer to the
-     * top of the current stack frame.
-     *
-     * At function entry, it pushes R7 into the stack, then allocates stack for
-     * the function. Then copies SP into R7, then decrement R7 by the amount of
-     * required stack allocations for the function. Then uses R7 to access the
-     * stack (all allocated variables are located at offsets from R7).
-     *
-     * So at function return, R7 is incremented by the number of allocated stack
-     * entries, then R7 is copied to SP, and the old value of R7 is popped from
-     * the stack.
-     *
-     * So we copy SP to R7 as the last step before function exit, to keep SP
-     * value unchanged.
-     *
-     * This works because, this function doesn't use any stack allocations
-     * at all (no local variables, or function calls)
-     * */
-    __asm ("MOV R7, sp\n\t");
+    /* task's privilege level, applied at exception return */
+    __set_CONTROL(Miros_RunningTask->control);
+    __ISB();
   }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return sp;
+}
+
+/**
+ * @brief PendSV handler, the context switch. Tasks run on PSP: the hardware
+ * stacks R0 - R3, R12, LR, PC and PSR on the task's stack, the handler saves
+ * R4 - R11 below them, and restores the next task's R4 - R11 and PSP. The
+ * handler itself runs on MSP.
+ * */
+MIROS_RAMFUNC __attribute__((naked)) void PendSV_Handler(void) {
+  __asm volatile (
+      "MRS    R0, PSP\n\t"
+      "STMDB  R0!, {R4-R11}\n\t"
+      "BL     Miros_Switch\n\t"
+      "LDMIA  R0!, {R4-R11}\n\t"
+      "MSR    PSP, R0\n\t"
+      "MVN    LR, #2\n\t"          /* MIROS_EXCEPTION_RETURN */
+      "BX     LR\n\t"
+  );
 }
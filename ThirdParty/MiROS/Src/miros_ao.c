@@ -0,0 +1,139 @@
+/******************************************************************************
+ * @file    miros_ao.c
+ * @brief   Active objects, event-driven tasks with their own event queues
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_event.h"
+#include "miros_bus.h"
+#include "miros_ao.h"
+
+static const Event_t Ao_InitEvent = MIROS_EVENT_STATIC(MIROS_SIGNAL_INIT);
+
+/**
+ * @brief Stackless active objects, and their shared ready semaphore, posted
+ * once for every event posted to them. The semaphore is initialized at load
+ * time, as the running task may already wait on it when the first stackless
+ * active object is started.
+ * */
+static volatile uint32_t Ao_Stackless = 0;
+static Semaphore_t Ao_Ready = { 0, NULL, NULL };
+
+HAL_StatusTypeDef MIROS_AoInitialize(ActiveObject_t *ao, uint32_t id,
+    AoDispatch_t dispatch, Event_t **buffer, uint32_t length) {
+  assert_param(ao != NULL);
+  assert_param(dispatch != NULL);
+
+  ao->dispatch = dispatch;
+
+  return MIROS_BusSubscriberInitialize(&ao->subscriber, id, buffer, length);
+}
+
+void MIROS_AoStart(ActiveObject_t *ao) {
+  ao->dispatch(ao, &Ao_InitEvent);
+}
+
+void MIROS_AoRun(ActiveObject_t *ao) {
+  MIROS_AoStart(ao);
+
+  for (;;) {
+    Event_t *event = MIROS_BusReceive(&ao->subscriber);
+
+    ao->dispatch(ao, event);
+    MIROS_EventGc(event);
+  }
+}
+
+void MIROS_AoStartStackless(ActiveObject_t *ao) {
+  EventQueue_t *queue = &ao->subscriber.queue;
+  uint32_t primask;
+
+  MIROS_AoStart(ao);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  /* count the events posted before it was started */
+  for (uint32_t i = 0; i < queue->used; i++) {
+    MIROS_SemPost(&Ao_Ready);
+  }
+
+  queue->ready = &Ao_Ready;
+  Ao_Stackless |= (1UL << ao->subscriber.id);
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+void MIROS_AoRunStackless(void) {
+  for (;;) {
+    uint32_t stackless;
+
+    MIROS_SemWait(&Ao_Ready);
+
+    /* a token may be left by an event taken by MIROS_AoRunOnce() */
+    stackless = Ao_Stackless;
+    while (stackless != 0) {
+      uint32_t id = 31 - __CLZ(stackless);
+
+      stackless &= ~(1UL << id);
+      if (MIROS_AoRunOnce((ActiveObject_t*) MIROS_BusGetSubscriber(id))) {
+        break;
+      }
+    }
+  }
+}
+
+uint32_t MIROS_AoRunOnce(ActiveObject_t *ao) {
+  Event_t *event = MIROS_BusTryReceive(&ao->subscriber);
+
+  if (event == NULL) {
+    return 0;
+  }
+
+  ao->dispatch(ao, event);
+  MIROS_EventGc(event);
+
+  return 1;
+}
+
+HAL_StatusTypeDef MIROS_AoPost(ActiveObject_t *ao, Event_t *event) {
+  return MIROS_EventQueuePost(&ao->subscriber.queue, event);
+}
+
+void MIROS_AoSubscribe(ActiveObject_t *ao, uint16_t signal) {
+  MIROS_BusSubscribe(&ao->subscriber, signal);
+}
+
+void MIROS_AoUnsubscribe(ActiveObject_t *ao, uint16_t signal) {
+  MIROS_BusUnsubscribe(&ao->subscriber, signal);
+}
+
+uint32_t MIROS_AoPublish(Event_t *event) {
+  return MIROS_BusPublish(event);
+}
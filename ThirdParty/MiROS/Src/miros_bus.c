@@ -0,0 +1,133 @@
+/******************************************************************************
+ * @file    miros_bus.c
+ * @brief   Publish-subscribe event bus, with static topic tables
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_event.h"
+#include "miros_bus.h"
+
+#if MIROS_BUS_SUBSCRIBERS > 32
+#error "MIROS_BUS_SUBSCRIBERS must be 32 or less"
+#endif
+
+static BusSubscriber_t *Bus_Subscribers[MIROS_BUS_SUBSCRIBERS];
+static volatile uint32_t Bus_Topics[MIROS_BUS_TOPICS];
+
+HAL_StatusTypeDef MIROS_BusSubscriberInitialize(BusSubscriber_t *subscriber,
+    uint32_t id, Event_t **buffer, uint32_t length) {
+  assert_param(subscriber != NULL);
+
+  if ((id >= MIROS_BUS_SUBSCRIBERS) || (Bus_Subscribers[id] != NULL)) {
+    return HAL_ERROR;
+  }
+
+  MIROS_EventQueueInitialize(&subscriber->queue, buffer, length);
+  subscriber->id = id;
+  subscriber->dropped = 0;
+
+  Bus_Subscribers[id] = subscriber;
+
+  return HAL_OK;
+}
+
+BusSubscriber_t* MIROS_BusGetSubscriber(uint32_t id) {
+  assert_param(id < MIROS_BUS_SUBSCRIBERS);
+
+  return Bus_Subscribers[id];
+}
+
+void MIROS_BusSubscribe(BusSubscriber_t *subscriber, uint16_t topic) {
+  uint32_t primask;
+
+  assert_param(topic < MIROS_BUS_TOPICS);
+
+  MIROS_CRITICAL_ENTER(primask);
+  Bus_Topics[topic] |= (1UL << subscriber->id);
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+void MIROS_BusUnsubscribe(BusSubscriber_t *subscriber, uint16_t topic) {
+  uint32_t primask;
+
+  assert_param(topic < MIROS_BUS_TOPICS);
+
+  MIROS_CRITICAL_ENTER(primask);
+  Bus_Topics[topic] &= ~(1UL << subscriber->id);
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+uint32_t MIROS_BusPublish(Event_t *event) {
+  uint32_t delivered = 0;
+  uint32_t subscribers;
+  uint32_t primask;
+
+  assert_param(event->signal < MIROS_BUS_TOPICS);
+
+  /**
+   * Post to all subscribers in one pass: the posts only pend the switch, so
+   * the subscribers are all made ready first, and the highest priority one
+   * runs once the critical section ends. The publisher holds a reference
+   * meanwhile, so an event without subscribers is still garbage collected.
+   * */
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (event->pool != 0) {
+    event->ref_count++;
+  }
+
+  subscribers = Bus_Topics[event->signal];
+  while (subscribers != 0) {
+    uint32_t id = 31 - __CLZ(subscribers);
+    BusSubscriber_t *subscriber = Bus_Subscribers[id];
+
+    subscribers &= ~(1UL << id);
+    if (MIROS_EventQueuePost(&subscriber->queue, event) == HAL_OK) {
+      delivered++;
+    } else {
+      subscriber->dropped++;
+    }
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  /* the publisher's reference */
+  MIROS_EventGc(event);
+
+  return delivered;
+}
+
+Event_t* MIROS_BusReceive(BusSubscriber_t *subscriber) {
+  return MIROS_EventQueueGet(&subscriber->queue);
+}
+
+Event_t* MIROS_BusTryReceive(BusSubscriber_t *subscriber) {
+  return MIROS_EventQueueTryGet(&subscriber->queue);
+}
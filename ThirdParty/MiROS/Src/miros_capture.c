@@ -0,0 +1,244 @@
+/******************************************************************************
+ * @file    miros_capture.c
+ * @brief   MiROS timer input capture measurement service (frequency, period, duty)
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_io.h"
+#include "miros_capture.h"
+
+/**
+ * @brief Get timer's DMA handle index of a capture channel (TIM_CHANNEL_x)
+ * */
+#define CAPTURE_DMA_ID(channel)     (((channel) / TIM_CHANNEL_2) + TIM_DMA_ID_CC1)
+
+/**
+ * @brief Sum of captured values, and their number
+ * */
+typedef struct {
+  uint64_t sum;
+  uint32_t count;
+} CaptureSum_t;
+
+static Capture_t *Capture_List = NULL;
+
+/**
+ * @brief Sum the values transferred by DMA into @p buffer since @p index
+ *
+ * @param [in] hdma DMA handle transferring the captures
+ * @param [in] buffer capture buffer
+ * @param [in] size number of half-words in @p buffer
+ * @param [in, out] index index of the next unprocessed capture
+ *
+ * @return CaptureSum_t: sum of the new captures
+ * */
+static CaptureSum_t Capture_Sum(DMA_HandleTypeDef *hdma, const uint16_t *buffer,
+    uint32_t size, uint32_t *index) {
+  CaptureSum_t result = { 0, 0 };
+  uint32_t position = (size - __HAL_DMA_GET_COUNTER(hdma)) % size;
+
+  while (*index != position) {
+    uint16_t value = buffer[*index];
+
+    /* first capture after start is not a complete period */
+    if (value != 0) {
+      result.sum += value;
+      result.count++;
+    }
+
+    *index = (*index + 1) % size;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Capture device's start function, read requests wait for the next
+ * update
+ * */
+static HAL_StatusTypeDef Capture_Start(IoDevice_t *device,
+    IoRequest_t *request) {
+  (void) device;
+
+  if ((request->operation != MIROS_IO_READ) || (request->length != 1)) {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+ * @brief Complete the read requests queued before an update, with its
+ * measurements
+ *
+ * @param [in] capture pointer to the capture structure
+ * @param [in] result measurements of the update
+ *
+ * @return void
+ * */
+static void Capture_Complete(Capture_t *capture,
+    const CaptureResult_t *result) {
+  uint32_t primask;
+  IoRequest_t *last;
+  IoRequest_t *request;
+
+  /* requests submitted from the callbacks wait for the next update */
+  MIROS_CRITICAL_ENTER(primask);
+  last = capture->device.tail;
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (last == NULL) {
+    return;
+  }
+
+  do {
+    request = capture->device.head;
+    *(CaptureResult_t*) request->buffer = *result;
+    MIROS_IoComplete(&capture->device, HAL_OK);
+  } while (request != last);
+}
+
+HAL_StatusTypeDef MIROS_CaptureInitialize(Capture_t *capture,
+    TIM_HandleTypeDef *htim, uint32_t period_channel, uint32_t pulse_channel,
+    uint32_t clock, uint16_t *periods, uint16_t *pulses, uint32_t size) {
+  uint32_t primask;
+  HAL_StatusTypeDef status;
+
+  assert_param(size > 0);
+  assert_param((pulse_channel == MIROS_CAPTURE_NO_CHANNEL) || (pulses != NULL));
+
+  capture->htim = htim;
+  capture->period_channel = period_channel;
+  capture->pulse_channel = pulse_channel;
+  capture->clock = clock;
+  capture->periods = periods;
+  capture->pulses = pulses;
+  capture->size = size;
+  capture->period_index = 0;
+  capture->pulse_index = 0;
+  capture->idle_updates = 0;
+  capture->result = (CaptureResult_t ) { 0 };
+  MIROS_IoDeviceInitialize(&capture->device, Capture_Start, NULL, capture);
+
+  /* buffers are half-words, DMA is configured for half-word transfers */
+  status = HAL_TIM_IC_Start_DMA(htim, period_channel, (uint32_t*) periods,
+      (uint16_t) size);
+
+  if ((status == HAL_OK) && (pulse_channel != MIROS_CAPTURE_NO_CHANNEL)) {
+    status = HAL_TIM_IC_Start_DMA(htim, pulse_channel, (uint32_t*) pulses,
+        (uint16_t) size);
+  }
+
+  if (status != HAL_OK) {
+    return status;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  capture->next = Capture_List;
+  Capture_List = capture;
+  MIROS_CRITICAL_EXIT(primask);
+
+  return HAL_OK;
+}
+
+void MIROS_CaptureUpdate(Capture_t *capture) {
+  uint32_t primask;
+  CaptureResult_t result = { 0 };
+  CaptureSum_t periods;
+  CaptureSum_t pulses = { 0, 0 };
+
+  periods = Capture_Sum(
+      capture->htim->hdma[CAPTURE_DMA_ID(capture->period_channel)],
+      capture->periods, capture->size, &capture->period_index);
+
+  if (capture->pulse_channel != MIROS_CAPTURE_NO_CHANNEL) {
+    pulses = Capture_Sum(
+        capture->htim->hdma[CAPTURE_DMA_ID(capture->pulse_channel)],
+        capture->pulses, capture->size, &capture->pulse_index);
+  }
+
+  if (periods.count == 0) {
+    /* keep the last measurements, until the signal times out */
+    if (capture->idle_updates < MIROS_CAPTURE_TIMEOUT) {
+      capture->idle_updates++;
+      return;
+    }
+  } else {
+    capture->idle_updates = 0;
+
+    /* average over all periods captured in this update */
+    result.edges = periods.count;
+    result.frequency = (uint32_t) (((uint64_t) capture->clock * 1000
+        * periods.count) / periods.sum);
+    result.period = (uint32_t) ((periods.sum * 1000000000ULL)
+        / ((uint64_t) capture->clock * periods.count));
+
+    if (pulses.count > 0) {
+      result.pulse = (uint32_t) ((pulses.sum * 1000000000ULL)
+          / ((uint64_t) capture->clock * pulses.count));
+      result.duty = (uint32_t) ((pulses.sum * periods.count * 10000)
+          / (periods.sum * pulses.count));
+    }
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  capture->result = result;
+  MIROS_CRITICAL_EXIT(primask);
+
+  Capture_Complete(capture, &result);
+}
+
+void MIROS_CaptureGet(Capture_t *capture, CaptureResult_t *result) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+  *result = capture->result;
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+HAL_StatusTypeDef MIROS_CaptureRead(Capture_t *capture,
+    CaptureResult_t *result) {
+  IoRequest_t request;
+
+  MIROS_IoRequestInitialize(&request, MIROS_IO_READ, 0, result, 1);
+
+  return MIROS_IoTransfer(&capture->device, &request);
+}
+
+void MIROS_CaptureTask(void) {
+  while (1) {
+    MIROS_TaskDelay(MIROS_CAPTURE_UPDATE_PERIOD);
+
+    for (Capture_t *capture = Capture_List; capture != NULL;
+        capture = capture->next) {
+      MIROS_CaptureUpdate(capture);
+    }
+  }
+}
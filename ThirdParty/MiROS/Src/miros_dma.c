@@ -0,0 +1,93 @@
+/******************************************************************************
+ * @file    miros_dma.c
+ * @brief   MiROS DMA memory-to-memory copy device, on MiROS I/O requests
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_io.h"
+#include "miros_dma.h"
+
+/**
+ * @brief DMA device's start function, starts a copy request
+ * */
+static HAL_StatusTypeDef Dma_Start(IoDevice_t *device, IoRequest_t *request) {
+  DMA_HandleTypeDef *hdma = (DMA_HandleTypeDef*) device->context;
+  uint32_t source;
+  uint32_t destination;
+
+  if (request->operation == MIROS_IO_READ) {
+    source = request->address;
+    destination = (uint32_t) request->buffer;
+  } else if (request->operation == MIROS_IO_WRITE) {
+    source = (uint32_t) request->buffer;
+    destination = request->address;
+  } else {
+    return HAL_ERROR;
+  }
+
+  return HAL_DMA_Start_IT(hdma, source, destination, request->length);
+}
+
+/**
+ * @brief DMA transfer complete callback
+ * */
+static void Dma_TransferComplete(DMA_HandleTypeDef *hdma) {
+  MIROS_IoComplete((IoDevice_t*) hdma->Parent, HAL_OK);
+}
+
+/**
+ * @brief DMA transfer error callback
+ * */
+static void Dma_TransferError(DMA_HandleTypeDef *hdma) {
+  MIROS_IoComplete((IoDevice_t*) hdma->Parent, HAL_ERROR);
+}
+
+void MIROS_DmaInitialize(IoDevice_t *device, DMA_HandleTypeDef *hdma) {
+  MIROS_IoDeviceInitialize(device, Dma_Start, NULL, hdma);
+
+  /* memory-to-memory transfers have no parent peripheral */
+  hdma->Parent = device;
+  hdma->XferCpltCallback = Dma_TransferComplete;
+  hdma->XferErrorCallback = Dma_TransferError;
+}
+
+HAL_StatusTypeDef MIROS_DmaCopy(IoDevice_t *device, void *destination,
+    const void *source, uint32_t length) {
+  IoRequest_t request;
+
+  if (length == 0) {
+    return HAL_OK;
+  }
+
+  MIROS_IoRequestInitialize(&request, MIROS_IO_WRITE, (uint32_t) destination,
+      (void*) source, length);
+
+  return MIROS_IoTransfer(device, &request);
+}
@@ -0,0 +1,223 @@
+/******************************************************************************
+ * @file    miros_event.c
+ * @brief   Events, event pools and event queues
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_event.h"
+
+/**
+ * @brief Event pool, free blocks are linked through their first word
+ * */
+typedef struct {
+  void *free;
+  uint32_t block_size;
+  uint32_t free_count;
+  uint32_t min_free;
+} EventPool_t;
+
+static EventPool_t Event_Pools[MIROS_EVENT_POOLS];
+static uint32_t Event_NumPools = 0;
+
+HAL_StatusTypeDef MIROS_EventPoolInitialize(uint32_t *storage,
+    uint32_t block_size, uint32_t count) {
+  EventPool_t *pool;
+  uint8_t *block = (uint8_t*) storage;
+  uint32_t i;
+
+  assert_param(storage != NULL);
+
+  if ((Event_NumPools >= MIROS_EVENT_POOLS)
+      || (block_size < sizeof(Event_t)) || ((block_size & 3UL) != 0)) {
+    return HAL_ERROR;
+  }
+
+  if ((Event_NumPools > 0)
+      && (block_size < Event_Pools[Event_NumPools - 1].block_size)) {
+    return HAL_ERROR;
+  }
+
+  pool = &Event_Pools[Event_NumPools];
+  pool->free = NULL;
+  pool->block_size = block_size;
+  pool->free_count = count;
+  pool->min_free = count;
+
+  /* link blocks in address order */
+  for (i = count; i > 0; i--) {
+    void **link = (void**) (block + ((i - 1) * block_size));
+
+    *link = pool->free;
+    pool->free = link;
+  }
+
+  Event_NumPools++;
+
+  return HAL_OK;
+}
+
+Event_t* MIROS_EventNew(uint32_t size, uint16_t signal) {
+  Event_t *event = NULL;
+  uint32_t primask;
+  uint32_t i;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  for (i = 0; i < Event_NumPools; i++) {
+    EventPool_t *pool = &Event_Pools[i];
+
+    if ((pool->block_size >= size) && (pool->free != NULL)) {
+      event = (Event_t*) pool->free;
+      pool->free = *(void**) pool->free;
+      pool->free_count--;
+      if (pool->free_count < pool->min_free) {
+        pool->min_free = pool->free_count;
+      }
+
+      event->pool = (uint8_t) (i + 1);
+      break;
+    }
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (event != NULL) {
+    event->signal = signal;
+    event->ref_count = 0;
+  }
+
+  return event;
+}
+
+void MIROS_EventGc(Event_t *event) {
+  uint32_t primask;
+
+  if (event->pool == 0) {
+    return;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (event->ref_count > 1) {
+    event->ref_count--;
+  } else {
+    EventPool_t *pool = &Event_Pools[event->pool - 1];
+
+    *(void**) event = pool->free;
+    pool->free = event;
+    pool->free_count++;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+uint32_t MIROS_EventPoolMinFree(uint32_t pool) {
+  assert_param(pool < Event_NumPools);
+
+  return Event_Pools[pool].min_free;
+}
+
+void MIROS_EventQueueInitialize(EventQueue_t *queue, Event_t **buffer,
+    uint32_t length) {
+  assert_param(buffer != NULL);
+  assert_param(length > 0);
+
+  queue->buffer = buffer;
+  queue->length = length;
+  queue->head = 0;
+  queue->tail = 0;
+  queue->used = 0;
+  queue->max_used = 0;
+  MIROS_SemInitialize(&queue->items, 0);
+  queue->ready = NULL;
+}
+
+HAL_StatusTypeDef MIROS_EventQueuePost(EventQueue_t *queue, Event_t *event) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (queue->used == queue->length) {
+    MIROS_CRITICAL_EXIT(primask);
+    return HAL_ERROR;
+  }
+
+  if (event->pool != 0) {
+    event->ref_count++;
+  }
+
+  queue->buffer[queue->tail] = event;
+  queue->tail = (queue->tail + 1 == queue->length) ? 0 : queue->tail + 1;
+  queue->used++;
+  if (queue->used > queue->max_used) {
+    queue->max_used = queue->used;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_SemPost(&queue->items);
+  if (queue->ready != NULL) {
+    MIROS_SemPost(queue->ready);
+  }
+
+  return HAL_OK;
+}
+
+/**
+ * @brief Remove the oldest event, the caller took one of the queue's tokens
+ * */
+static Event_t* Event_QueueRemove(EventQueue_t *queue) {
+  Event_t *event;
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  event = queue->buffer[queue->head];
+  queue->head = (queue->head + 1 == queue->length) ? 0 : queue->head + 1;
+  queue->used--;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return event;
+}
+
+Event_t* MIROS_EventQueueGet(EventQueue_t *queue) {
+  MIROS_SemWait(&queue->items);
+
+  return Event_QueueRemove(queue);
+}
+
+Event_t* MIROS_EventQueueTryGet(EventQueue_t *queue) {
+  if (!MIROS_SemTryWait(&queue->items)) {
+    return NULL;
+  }
+
+  return Event_QueueRemove(queue);
+}
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * @file    miros_fiber.c
+ * @brief   Cooperative fibers, multiplexed inside one MiROS task
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_fiber.h"
+
+/**
+ * @brief Number of words in the switch frame, R3-R11 and LR (R3 keeps the
+ * stack 8 byte aligned)
+ * */
+#define FIBER_FRAME_SIZE            10
+
+static Fiber_t *Fiber_List = NULL;
+static Fiber_t *Fiber_Running = NULL;
+static uint32_t *Fiber_SchedulerSp = NULL;
+
+/**
+ * @brief Save the callee-saved registers and SP into @p save, and resume the
+ * context saved at @p load
+ * */
+__attribute__((naked)) static void Fiber_Switch(
+    __attribute__((unused)) uint32_t **save,
+    __attribute__((unused)) uint32_t *load) {
+  __asm volatile (
+      "PUSH  {R3-R11, LR}\n\t"
+      "MOV   R2, SP\n\t"
+      "STR   R2, [R0]\n\t"
+      "MOV   SP, R1\n\t"
+      "POP   {R3-R11, PC}\n\t"
+  );
+}
+
+/**
+ * @brief First function of all fibers, its address is the return address of
+ * the fiber's initial switch frame
+ * */
+static void Fiber_Entry(void) {
+  Fiber_t *fiber = Fiber_Running;
+
+  fiber->handle(fiber->argument);
+  fiber->state = MIROS_FIBER_DONE;
+
+  Fiber_Switch(&fiber->stack_ptr, Fiber_SchedulerSp);
+}
+
+HAL_StatusTypeDef MIROS_FiberCreate(Fiber_t *fiber, FiberHandle_t handle,
+    void *argument, uint32_t *stack, uint32_t stack_size) {
+  Fiber_t **link = &Fiber_List;
+  uint32_t *sp;
+  uint32_t i;
+
+  assert_param(fiber != NULL);
+  assert_param(handle != NULL);
+  assert_param(stack != NULL);
+
+  if (stack_size < MIROS_FIBER_MIN_STACK_SIZE) {
+    return HAL_ERROR;
+  }
+
+  sp = (uint32_t*) ((uint32_t) (stack + stack_size)
+      & ~(MIROS_STACK_ALIGNMENT - 1UL));
+
+  sp -= FIBER_FRAME_SIZE;
+  for (i = 0; i < (FIBER_FRAME_SIZE - 1); i++) {
+    sp[i] = 0;
+  }
+  sp[FIBER_FRAME_SIZE - 1] = (uint32_t) Fiber_Entry; /* LR, popped to PC */
+
+  fiber->stack_ptr = sp;
+  fiber->next = NULL;
+  fiber->handle = handle;
+  fiber->argument = argument;
+  fiber->state = MIROS_FIBER_READY;
+  fiber->wake = 0;
+
+  /* append, fibers created by a running fiber run in the same pass */
+  while (*link != NULL) {
+    link = &(*link)->next;
+  }
+  *link = fiber;
+
+  return HAL_OK;
+}
+
+void MIROS_FiberRun(void) {
+  while (Fiber_List != NULL) {
+    Fiber_t **link = &Fiber_List;
+    uint32_t ran = 0;
+
+    while (*link != NULL) {
+      Fiber_t *fiber = *link;
+
+      if ((fiber->state == MIROS_FIBER_SLEEPING)
+          && ((int32_t) (HAL_GetTick() - fiber->wake) >= 0)) {
+        fiber->state = MIROS_FIBER_READY;
+      }
+
+      if (fiber->state == MIROS_FIBER_READY) {
+        Fiber_Running = fiber;
+        Fiber_Switch(&Fiber_SchedulerSp, fiber->stack_ptr);
+        Fiber_Running = NULL;
+        ran = 1;
+      }
+
+      if (fiber->state == MIROS_FIBER_DONE) {
+        *link = fiber->next;
+      } else {
+        link = &fiber->next;
+      }
+    }
+
+    /* all fibers are sleeping, let lower priority tasks run */
+    if (!ran) {
+      MIROS_TaskDelay(1);
+    }
+  }
+}
+
+void MIROS_FiberYield(void) {
+  Fiber_t *fiber = Fiber_Running;
+
+  assert_param(fiber != NULL);
+
+  Fiber_Switch(&fiber->stack_ptr, Fiber_SchedulerSp);
+}
+
+void MIROS_FiberDelay(uint32_t ticks) {
+  Fiber_t *fiber = Fiber_Running;
+
+  assert_param(fiber != NULL);
+
+  if (ticks == 0) {
+    MIROS_FiberYield();
+    return;
+  }
+
+  fiber->wake = HAL_GetTick() + ticks;
+  fiber->state = MIROS_FIBER_SLEEPING;
+
+  Fiber_Switch(&fiber->stack_ptr, Fiber_SchedulerSp);
+}
+
+void MIROS_FiberSemWait(Semaphore_t *sem) {
+  while (!MIROS_SemTryWait(sem)) {
+    MIROS_FiberDelay(1);
+  }
+}
+
+Fiber_t* MIROS_FiberSelf(void) {
+  return Fiber_Running;
+}
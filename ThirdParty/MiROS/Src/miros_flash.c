@@ -0,0 +1,225 @@
+/******************************************************************************
+ * @file    miros_flash.c
+ * @brief   MiROS non-blocking internal flash programming service
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_io.h"
+#include "miros_flash.h"
+
+/**
+ * @brief Number of vector table entries (16 system exceptions,
+ * followed by the device interrupts)
+ * */
+#define FLASH_VECTOR_TABLE_SIZE     (16 + USBWakeUp_IRQn + 1)
+
+/**
+ * @brief Vector table alignment (the next power of 2 of the vector table's
+ * size in bytes)
+ * */
+#define FLASH_VECTOR_TABLE_ALIGN    256
+
+/**
+ * @brief Flash status register error flags
+ * */
+#define FLASH_SR_ERRORS             (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)
+
+static uint32_t Flash_VectorTable[FLASH_VECTOR_TABLE_SIZE]
+    __ALIGNED(FLASH_VECTOR_TABLE_ALIGN);
+
+static IoDevice_t Flash_Device;
+static volatile uint32_t Flash_Error = 0;
+
+/**
+ * @brief Progress of the request in progress (next half-word to program and
+ * its address, or next page to erase, and number of remaining half-words or
+ * pages)
+ * */
+static uint32_t Flash_Address = 0;
+static const uint16_t *Flash_Data = NULL;
+static uint32_t Flash_Remaining = 0;
+
+/**
+ * @brief Start programming the next half-word, or erasing the next page,
+ * of the request in progress. Its end is signaled by the flash interrupt.
+ *
+ * The flash controller is driven through its registers, so that nothing
+ * runs from flash while the flash is busy (HAL flash driver is in flash).
+ * */
+MIROS_RAMFUNC static void Flash_Step(IoOperation_t operation) {
+  if (operation == MIROS_IO_WRITE) {
+    FLASH->CR = FLASH_CR_PG | FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+    *(volatile uint16_t*) Flash_Address = *Flash_Data;
+  } else {
+    FLASH->CR = FLASH_CR_PER | FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+    FLASH->AR = Flash_Address;
+    FLASH->CR |= FLASH_CR_STRT;
+  }
+}
+
+/**
+ * @brief Flash device's start function, unlocks the flash, then starts a
+ * program or erase request
+ * */
+MIROS_RAMFUNC static HAL_StatusTypeDef Flash_Start(IoDevice_t *device,
+    IoRequest_t *request) {
+  (void) device;
+
+  if (((request->operation != MIROS_IO_WRITE)
+      && (request->operation != MIROS_IO_ERASE)) || (request->length == 0)) {
+    return HAL_ERROR;
+  }
+
+  if (FLASH->CR & FLASH_CR_LOCK) {
+    FLASH->KEYR = FLASH_KEY1;
+    FLASH->KEYR = FLASH_KEY2;
+    if (FLASH->CR & FLASH_CR_LOCK) {
+      return HAL_ERROR;
+    }
+  }
+
+  FLASH->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+  Flash_Error = 0;
+
+  Flash_Address = request->address;
+  Flash_Data = (const uint16_t*) request->buffer;
+  Flash_Remaining = request->length;
+
+  Flash_Step(request->operation);
+
+  return HAL_OK;
+}
+
+/**
+ * @brief Flash device's idle function, locks the flash
+ * */
+MIROS_RAMFUNC static void Flash_Idle(IoDevice_t *device) {
+  (void) device;
+
+  FLASH->CR = FLASH_CR_LOCK;
+}
+
+void MIROS_FlashInitialize(uint32_t irq_priority) {
+  uint32_t primask;
+  const uint32_t *vectors = (const uint32_t*) SCB->VTOR;
+
+  MIROS_IoDeviceInitialize(&Flash_Device, Flash_Start, Flash_Idle, NULL);
+  Flash_Error = 0;
+
+  /* relocate vector table to RAM */
+  for (uint32_t index = 0; index < FLASH_VECTOR_TABLE_SIZE; index++) {
+    Flash_VectorTable[index] = vectors[index];
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+  SCB->VTOR = (uint32_t) Flash_VectorTable;
+  __DSB();
+  MIROS_CRITICAL_EXIT(primask);
+
+  HAL_NVIC_SetPriority(FLASH_IRQn, irq_priority, 0);
+  HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+IoDevice_t* MIROS_FlashGetDevice(void) {
+  return &Flash_Device;
+}
+
+MIROS_RAMFUNC HAL_StatusTypeDef MIROS_FlashProgram(uint32_t address,
+    const uint16_t *data, uint32_t count) {
+  IoRequest_t request;
+
+  if (count == 0) {
+    return HAL_OK;
+  }
+
+  if ((address & (sizeof(uint16_t) - 1)) != 0) {
+    return HAL_ERROR;
+  }
+
+  MIROS_IoRequestInitialize(&request, MIROS_IO_WRITE, address,
+      (void*) data, count);
+
+  return MIROS_IoTransfer(&Flash_Device, &request);
+}
+
+MIROS_RAMFUNC HAL_StatusTypeDef MIROS_FlashErase(uint32_t page_address,
+    uint32_t nb_pages) {
+  IoRequest_t request;
+
+  if (nb_pages == 0) {
+    return HAL_OK;
+  }
+
+  MIROS_IoRequestInitialize(&request, MIROS_IO_ERASE, page_address, NULL,
+      nb_pages);
+
+  return MIROS_IoTransfer(&Flash_Device, &request);
+}
+
+uint32_t MIROS_FlashGetError(void) {
+  return Flash_Error;
+}
+
+MIROS_RAMFUNC void FLASH_IRQHandler(void) {
+  IoRequest_t *request = Flash_Device.head;
+  uint32_t status = FLASH->SR;
+
+  FLASH->SR = status & (FLASH_SR_EOP | FLASH_SR_ERRORS);
+  FLASH->CR &= ~(FLASH_CR_PG | FLASH_CR_PER);
+
+  if (request == NULL) {
+    return;
+  }
+
+  if (status & FLASH_SR_ERRORS) {
+    Flash_Error = status & FLASH_SR_ERRORS;
+    MIROS_IoComplete(&Flash_Device, HAL_ERROR);
+    return;
+  }
+
+  if (!(status & FLASH_SR_EOP)) {
+    return;
+  }
+
+  Flash_Remaining--;
+  if (Flash_Remaining > 0) {
+    if (request->operation == MIROS_IO_WRITE) {
+      Flash_Address += sizeof(uint16_t);
+      Flash_Data++;
+    } else {
+      Flash_Address += FLASH_PAGE_SIZE;
+    }
+    Flash_Step(request->operation);
+    return;
+  }
+
+  /* starts the next queued request, if any, before notifying */
+  MIROS_IoComplete(&Flash_Device, HAL_OK);
+}
@@ -0,0 +1,249 @@
+/******************************************************************************
+ * @file    miros_hsm.c
+ * @brief   Hierarchical state machines, with time events
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_event.h"
+#include "miros_timer.h"
+#include "miros_hsm.h"
+
+static const Event_t Hsm_EntryEvent = MIROS_EVENT_STATIC(MIROS_SIGNAL_ENTRY);
+static const Event_t Hsm_ExitEvent = MIROS_EVENT_STATIC(MIROS_SIGNAL_EXIT);
+static const Event_t Hsm_InitEvent = MIROS_EVENT_STATIC(MIROS_SIGNAL_INIT);
+
+/**
+ * @brief Find the least common ancestor of a transition from @p source to
+ * @p target
+ * */
+static const HsmState_t* Hsm_Lca(const HsmState_t *source,
+    const HsmState_t *target) {
+  const HsmState_t *ancestor;
+  const HsmState_t *state;
+
+  /* self transition, exit and re-enter the source */
+  if (target == source) {
+    return source->parent;
+  }
+
+  /* local transition to a substate of the source */
+  for (state = target->parent; state != NULL; state = state->parent) {
+    if (state == source) {
+      return source;
+    }
+  }
+
+  for (ancestor = source->parent; ancestor != NULL;
+      ancestor = ancestor->parent) {
+    for (state = target->parent; state != NULL; state = state->parent) {
+      if (state == ancestor) {
+        return ancestor;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Enter states from below @p lca down to @p target, outermost first
+ * */
+static void Hsm_EnterPath(Hsm_t *hsm, const HsmState_t *target,
+    const HsmState_t *lca) {
+  const HsmState_t *path[MIROS_HSM_MAX_DEPTH];
+  uint32_t depth = 0;
+
+  for (; target != lca; target = target->parent) {
+    path[depth++] = target;
+  }
+
+  while (depth > 0) {
+    const HsmState_t *state = path[--depth];
+
+    if (state->entry != NULL) {
+      state->entry(hsm, &Hsm_EntryEvent);
+    }
+  }
+}
+
+/**
+ * @brief Enter @p target from @p lca, then follow initial transitions down
+ * to a leaf state
+ * */
+static void Hsm_Enter(Hsm_t *hsm, const HsmState_t *target,
+    const HsmState_t *lca) {
+  Hsm_EnterPath(hsm, target, lca);
+
+  while (target->initial != NULL) {
+    if (target->init != NULL) {
+      target->init(hsm, &Hsm_InitEvent);
+    }
+    Hsm_EnterPath(hsm, target->initial, target);
+    target = target->initial;
+  }
+
+  hsm->state = target;
+}
+
+HAL_StatusTypeDef MIROS_HsmPrepare(HsmState_t *const *states,
+    uint32_t count) {
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0; i < count; i++) {
+    HsmState_t *state = states[i];
+    const HsmState_t *parent = state->parent;
+    uint32_t depth = 1;
+
+    for (; parent != NULL; parent = parent->parent) {
+      depth++;
+    }
+    if (depth > MIROS_HSM_MAX_DEPTH) {
+      return HAL_ERROR;
+    }
+
+    for (j = 0; j < state->num_transitions; j++) {
+      HsmTransition_t *transition = &state->transitions[j];
+
+      if (transition->target != NULL) {
+        transition->lca = Hsm_Lca(state, transition->target);
+      }
+    }
+  }
+
+  return HAL_OK;
+}
+
+void MIROS_HsmInitialize(Hsm_t *hsm, const HsmState_t *initial,
+    void *context) {
+  assert_param(initial != NULL);
+
+  hsm->state = NULL;
+  hsm->initial = initial;
+  hsm->context = context;
+}
+
+void MIROS_HsmStart(Hsm_t *hsm) {
+  Hsm_Enter(hsm, hsm->initial, NULL);
+}
+
+uint32_t MIROS_HsmDispatch(Hsm_t *hsm, const Event_t *event) {
+  const HsmState_t *source;
+
+  if (hsm->state == NULL) {
+    if (event->signal != MIROS_SIGNAL_INIT) {
+      return 0;
+    }
+    MIROS_HsmStart(hsm);
+    return 1;
+  }
+
+  for (source = hsm->state; source != NULL; source = source->parent) {
+    uint32_t i;
+
+    for (i = 0; i < source->num_transitions; i++) {
+      const HsmTransition_t *transition = &source->transitions[i];
+      const HsmState_t *state;
+
+      if ((transition->signal != event->signal)
+          || ((transition->guard != NULL)
+              && !transition->guard(hsm, event))) {
+        continue;
+      }
+
+      if (transition->target == NULL) {
+        if (transition->action != NULL) {
+          transition->action(hsm, event);
+        }
+        return 1;
+      }
+
+      /* exit up to the least common ancestor */
+      for (state = hsm->state; state != transition->lca;
+          state = state->parent) {
+        if (state->exit != NULL) {
+          state->exit(hsm, &Hsm_ExitEvent);
+        }
+      }
+
+      if (transition->action != NULL) {
+        transition->action(hsm, event);
+      }
+
+      Hsm_Enter(hsm, transition->target, transition->lca);
+
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+uint32_t MIROS_HsmIsIn(const Hsm_t *hsm, const HsmState_t *state) {
+  const HsmState_t *current;
+
+  for (current = hsm->state; current != NULL; current = current->parent) {
+    if (current == state) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Time event's timer callback, called from the kernel tick
+ * */
+static void Hsm_TimeEventExpired(Timer_t *timer) {
+  TimeEvent_t *time_event = (TimeEvent_t*) timer->context;
+
+  (void) MIROS_EventQueuePost(time_event->queue, &time_event->event);
+}
+
+void MIROS_TimeEventInitialize(TimeEvent_t *time_event, uint16_t signal,
+    EventQueue_t *queue) {
+  assert_param(queue != NULL);
+
+  MIROS_TimerInitialize(&time_event->timer, Hsm_TimeEventExpired,
+      time_event);
+  time_event->event.signal = signal;
+  time_event->event.pool = 0;
+  time_event->event.ref_count = 0;
+  time_event->queue = queue;
+}
+
+void MIROS_TimeEventArm(TimeEvent_t *time_event, uint32_t ticks,
+    uint32_t period) {
+  MIROS_TimerStart(&time_event->timer, ticks, period);
+}
+
+uint32_t MIROS_TimeEventDisarm(TimeEvent_t *time_event) {
+  return MIROS_TimerStop(&time_event->timer);
+}
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * @file    miros_io.c
+ * @brief   MiROS asynchronous I/O requests and per-device request queues
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_io.h"
+
+/**
+ * @brief Remove the request at the head of the device's queue. When the
+ * queue is empty, the device is marked idle, and the driver's idle function
+ * is called.
+ *
+ * @param [in] device pointer to the device
+ * @param [out] more set to 1 if there are more queued requests, and the
+ *    caller must start them
+ *
+ * @return IoRequest_t *: removed request
+ * */
+MIROS_RAMFUNC static IoRequest_t* Io_Dequeue(IoDevice_t *device,
+    uint32_t *more) {
+  uint32_t primask;
+  IoRequest_t *request;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  request = device->head;
+  device->head = request->next;
+  if (device->head == NULL) {
+    device->tail = NULL;
+    device->busy = 0;
+    if (device->idle != NULL) {
+      device->idle(device);
+    }
+  }
+  *more = device->busy;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return request;
+}
+
+/**
+ * @brief Signal a request's completion, to its waiting task and callback.
+ * The semaphore is posted first, so a callback may resubmit the request.
+ * */
+MIROS_RAMFUNC static void Io_Notify(IoRequest_t *request,
+    HAL_StatusTypeDef status) {
+  IoCallback_t callback = request->callback;
+
+  request->status = status;
+  request->pending = 0;
+
+  MIROS_SemPost(&request->done);
+
+  if (callback != NULL) {
+    callback(request);
+  }
+}
+
+/**
+ * @brief Start the request at the head of the device's queue, completes
+ * requests that fail to start, until a request is started or the queue is
+ * empty.
+ *
+ * Only the context that marked the device busy starts requests, and they
+ * are started outside critical sections, as starting a request may stall
+ * the CPU (flash programming), and interrupts must be serviced meanwhile.
+ *
+ * @pre device is busy, and its queue is not empty
+ * */
+MIROS_RAMFUNC static void Io_Start(IoDevice_t *device) {
+  uint32_t more = 1;
+
+  while (more && (device->start(device, device->head) != HAL_OK)) {
+    Io_Notify(Io_Dequeue(device, &more), HAL_ERROR);
+  }
+}
+
+void MIROS_IoDeviceInitialize(IoDevice_t *device, IoStart_t start,
+    IoIdle_t idle, void *context) {
+  device->start = start;
+  device->idle = idle;
+  device->context = context;
+  device->head = NULL;
+  device->tail = NULL;
+  device->busy = 0;
+}
+
+MIROS_RAMFUNC void MIROS_IoRequestInitialize(IoRequest_t *request,
+    IoOperation_t operation, uint32_t address, void *buffer, uint32_t length) {
+  request->operation = operation;
+  request->address = address;
+  request->buffer = buffer;
+  request->length = length;
+  request->callback = NULL;
+  request->context = NULL;
+  request->status = HAL_OK;
+  request->pending = 0;
+  request->next = NULL;
+}
+
+MIROS_RAMFUNC void MIROS_IoSubmit(IoDevice_t *device, IoRequest_t *request,
+    IoCallback_t callback, void *context) {
+  uint32_t primask;
+  uint32_t start;
+
+  request->callback = callback;
+  request->context = context;
+  request->status = HAL_BUSY;
+  request->pending = 1;
+  request->next = NULL;
+  MIROS_SemInitialize(&request->done, 0);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (device->head == NULL) {
+    device->head = request;
+  } else {
+    device->tail->next = request;
+  }
+  device->tail = request;
+
+  /* requests queued on a busy device are started by its ISR */
+  start = !device->busy;
+  device->busy = 1;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (start) {
+    Io_Start(device);
+  }
+}
+
+MIROS_RAMFUNC HAL_StatusTypeDef MIROS_IoWait(IoRequest_t *request) {
+  MIROS_SemWait(&request->done);
+
+  return request->status;
+}
+
+MIROS_RAMFUNC HAL_StatusTypeDef MIROS_IoTransfer(IoDevice_t *device,
+    IoRequest_t *request) {
+  MIROS_IoSubmit(device, request, NULL, NULL);
+
+  return MIROS_IoWait(request);
+}
+
+MIROS_RAMFUNC void MIROS_IoComplete(IoDevice_t *device,
+    HAL_StatusTypeDef status) {
+  uint32_t more;
+  IoRequest_t *request = Io_Dequeue(device, &more);
+
+  /* keep the device busy, start the next request before notifying */
+  if (more) {
+    Io_Start(device);
+  }
+
+  Io_Notify(request, status);
+}
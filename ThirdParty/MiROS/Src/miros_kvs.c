@@ -0,0 +1,552 @@
+/******************************************************************************
+ * @file    miros_kvs.c
+ * @brief   MiROS wear-leveled key-value store on internal flash pages
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_io.h"
+#include "miros_flash.h"
+#include "miros_kvs.h"
+
+/**
+ * @brief Page header: sequence number half-word, followed by the page magic
+ * half-word. The magic is programmed last, it marks the page as valid.
+ * */
+#define KVS_PAGE_MAGIC              0x4B56
+#define KVS_PAGE_HEADER_SIZE        (2 * sizeof(uint16_t))
+
+/**
+ * @brief Erased flash half-word
+ * */
+#define KVS_ERASED                  0xFFFF
+
+/**
+ * @brief Key of records that only skip over unusable space (records that
+ * were being written when power was lost)
+ * */
+#define KVS_KEY_SKIP                0
+
+/**
+ * @brief Invalid page index
+ * */
+#define KVS_NO_PAGE                 0xFFFFFFFF
+
+/**
+ * @brief Record header: key in the low byte, value size (bytes) in the high
+ * byte. Keys are never 0xFF, so a committed header is never erased (0xFFFF).
+ * */
+#define KVS_RECORD_HEADER(key, size)  ((uint16_t)(((size) << 8) | (key)))
+#define KVS_RECORD_KEY(header)        ((uint32_t)(header) & 0xFF)
+#define KVS_RECORD_SIZE(header)       ((uint32_t)(header) >> 8)
+
+/**
+ * @brief Number of half-words needed to hold @p size bytes
+ * */
+#define KVS_HALF_WORDS(size)        (((size) + 1) / 2)
+
+/**
+ * @brief Total record length in bytes (header and value)
+ * */
+#define KVS_RECORD_LENGTH(size)     \
+  (sizeof(uint16_t) * (1 + KVS_HALF_WORDS(size)))
+
+#define KVS_PAGE_ADDRESS(page)      \
+  (MIROS_KVS_FIRST_PAGE + ((page) * FLASH_PAGE_SIZE))
+
+#define KVS_READ(address)           (*(const volatile uint16_t*) (address))
+
+/**
+ * @brief Page states
+ *
+ * KVS_PAGE_FREE: page is erased and can become the head of the log
+ * KVS_PAGE_USED: page is part of the log
+ * KVS_PAGE_DIRTY: page has no live records, and needs to be erased
+ * KVS_PAGE_ERASING: page is being erased by the compaction task
+ * */
+typedef enum {
+  KVS_PAGE_FREE = 0,
+  KVS_PAGE_USED,
+  KVS_PAGE_DIRTY,
+  KVS_PAGE_ERASING,
+} KvsPageState_t;
+
+static KvsPageState_t Kvs_PageState[MIROS_KVS_NUM_PAGES] = { 0 };
+static uint16_t Kvs_PageSequence[MIROS_KVS_NUM_PAGES] = { 0 };
+
+/**
+ * @brief RAM index, address of the latest record of each key (0 if the key
+ * is not found)
+ * */
+static uint32_t Kvs_Index[MIROS_KVS_NUM_KEYS + 1] = { 0 };
+
+static uint32_t Kvs_ActivePage = KVS_NO_PAGE;
+static uint32_t Kvs_WriteAddress = 0;
+
+static Semaphore_t Kvs_Lock;
+static Semaphore_t Kvs_CompactRequest;
+
+/**
+ * @brief Compare page sequence numbers, handles sequence number wrap around
+ *
+ * @return int32_t: negative if @p a is older than @p b
+ * */
+static int32_t Kvs_CompareSequence(uint16_t a, uint16_t b) {
+  return (int32_t) (int16_t) (a - b);
+}
+
+/**
+ * @brief Check whether the flash range [@p start, @p end) is erased
+ * */
+static uint32_t Kvs_IsErased(uint32_t start, uint32_t end) {
+  for (uint32_t address = start; address < end; address += sizeof(uint16_t)) {
+    if (KVS_READ(address) != KVS_ERASED) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static uint32_t Kvs_CountPages(KvsPageState_t state) {
+  uint32_t count = 0;
+
+  for (uint32_t page = 0; page < MIROS_KVS_NUM_PAGES; page++) {
+    if (Kvs_PageState[page] == state) {
+      count++;
+    }
+  }
+  return count;
+}
+
+static uint32_t Kvs_FindPage(KvsPageState_t state) {
+  for (uint32_t page = 0; page < MIROS_KVS_NUM_PAGES; page++) {
+    if (Kvs_PageState[page] == state) {
+      return page;
+    }
+  }
+  return KVS_NO_PAGE;
+}
+
+/**
+ * @brief Find the oldest page of the log, other than the active page
+ * */
+static uint32_t Kvs_FindOldestPage(void) {
+  uint32_t oldest = KVS_NO_PAGE;
+
+  for (uint32_t page = 0; page < MIROS_KVS_NUM_PAGES; page++) {
+    if ((Kvs_PageState[page] == KVS_PAGE_USED) && (page != Kvs_ActivePage)) {
+      if ((oldest == KVS_NO_PAGE)
+          || (Kvs_CompareSequence(Kvs_PageSequence[page],
+              Kvs_PageSequence[oldest]) < 0)) {
+        oldest = page;
+      }
+    }
+  }
+  return oldest;
+}
+
+/**
+ * @brief Request background compaction, if fewer than
+ * #MIROS_KVS_SPARE_PAGES pages are erased
+ * */
+static void Kvs_CheckSpare(void) {
+  if ((Kvs_CountPages(KVS_PAGE_FREE) < MIROS_KVS_SPARE_PAGES)
+      || (Kvs_CountPages(KVS_PAGE_DIRTY) > 0)) {
+    MIROS_SemPost(&Kvs_CompactRequest);
+  }
+}
+
+/**
+ * @brief Replay the records of a page into the RAM index
+ *
+ * @return uint32_t: address after the last record of the page
+ * */
+static uint32_t Kvs_ReplayPage(uint32_t page) {
+  uint32_t address = KVS_PAGE_ADDRESS(page) + KVS_PAGE_HEADER_SIZE;
+  uint32_t limit = KVS_PAGE_ADDRESS(page) + FLASH_PAGE_SIZE;
+
+  while (address < limit) {
+    uint16_t header = KVS_READ(address);
+    uint32_t key = KVS_RECORD_KEY(header);
+    uint32_t size = KVS_RECORD_SIZE(header);
+
+    if (header == KVS_ERASED) {
+      break;
+    }
+
+    if ((address + KVS_RECORD_LENGTH(size)) > limit) {
+      /* corrupted header, the rest of the page is unusable */
+      address = limit;
+      break;
+    }
+
+    if ((key != KVS_KEY_SKIP) && (key <= MIROS_KVS_NUM_KEYS)) {
+      Kvs_Index[key] = (size > 0) ? address : 0;
+    }
+
+    address += KVS_RECORD_LENGTH(size);
+  }
+
+  return address;
+}
+
+/**
+ * @brief Find the write address of the active page. Value half-words of a
+ * record that was being written when power was lost are covered by a skip
+ * record, so the page can still be replayed.
+ * */
+static void Kvs_RepairActivePage(uint32_t address) {
+  uint32_t limit = KVS_PAGE_ADDRESS(Kvs_ActivePage) + FLASH_PAGE_SIZE;
+  uint32_t end = limit;
+  uint32_t size;
+  uint16_t header;
+
+  while ((end > address) && (KVS_READ(end - sizeof(uint16_t)) == KVS_ERASED)) {
+    end -= sizeof(uint16_t);
+  }
+
+  if (end > address) {
+    size = end - address - sizeof(uint16_t);
+    header = KVS_RECORD_HEADER(KVS_KEY_SKIP, size);
+
+    if ((size <= 0xFF) && (MIROS_FlashProgram(address, &header, 1) == HAL_OK)) {
+      address = end;
+    } else {
+      /* can't skip over it, the rest of the page is unusable */
+      address = limit;
+    }
+  }
+
+  Kvs_WriteAddress = address;
+}
+
+/**
+ * @brief Make an erased page the head of the log
+ *
+ * @pre Kvs_Lock is taken
+ * */
+static HAL_StatusTypeDef Kvs_OpenPage(void) {
+  uint16_t header[2];
+  uint32_t page = KVS_NO_PAGE;
+  HAL_StatusTypeDef status;
+
+  /* pick the next erased page after the active one, to spread wear */
+  for (uint32_t count = 1; count <= MIROS_KVS_NUM_PAGES; count++) {
+    uint32_t candidate = (Kvs_ActivePage == KVS_NO_PAGE) ?
+        (count - 1) : ((Kvs_ActivePage + count) % MIROS_KVS_NUM_PAGES);
+
+    if (Kvs_PageState[candidate] == KVS_PAGE_FREE) {
+      page = candidate;
+      break;
+    }
+  }
+
+  /* compaction is behind, erase a dirty page in the foreground */
+  if (page == KVS_NO_PAGE) {
+    page = Kvs_FindPage(KVS_PAGE_DIRTY);
+    if (page == KVS_NO_PAGE) {
+      return HAL_BUSY;
+    }
+
+    status = MIROS_FlashErase(KVS_PAGE_ADDRESS(page), 1);
+    if (status != HAL_OK) {
+      return status;
+    }
+    Kvs_PageState[page] = KVS_PAGE_FREE;
+  }
+
+  header[0] = (Kvs_ActivePage == KVS_NO_PAGE) ?
+      0 : (uint16_t) (Kvs_PageSequence[Kvs_ActivePage] + 1);
+  if (header[0] == KVS_ERASED) {
+    header[0] = 0;
+  }
+  header[1] = KVS_PAGE_MAGIC;
+
+  status = MIROS_FlashProgram(KVS_PAGE_ADDRESS(page), header, 2);
+  if (status != HAL_OK) {
+    Kvs_PageState[page] = KVS_PAGE_DIRTY;
+    return status;
+  }
+
+  Kvs_PageState[page] = KVS_PAGE_USED;
+  Kvs_PageSequence[page] = header[0];
+  Kvs_ActivePage = page;
+  Kvs_WriteAddress = KVS_PAGE_ADDRESS(page) + KVS_PAGE_HEADER_SIZE;
+
+  Kvs_CheckSpare();
+
+  return HAL_OK;
+}
+
+/**
+ * @brief Append a record to the head of the log, and update the RAM index.
+ * The value is programmed first, then the header (commit).
+ *
+ * @pre Kvs_Lock is taken
+ *
+ * @param [in] key record's key
+ * @param [in] data value half-words (in RAM)
+ * @param [in] size value size in bytes
+ * */
+static HAL_StatusTypeDef Kvs_Append(uint32_t key, const uint16_t *data,
+    uint32_t size) {
+  uint32_t address;
+  uint16_t header;
+  HAL_StatusTypeDef status;
+
+  if ((Kvs_ActivePage == KVS_NO_PAGE)
+      || ((Kvs_WriteAddress + KVS_RECORD_LENGTH(size))
+          > (KVS_PAGE_ADDRESS(Kvs_ActivePage) + FLASH_PAGE_SIZE))) {
+    status = Kvs_OpenPage();
+    if (status != HAL_OK) {
+      return status;
+    }
+  }
+
+  address = Kvs_WriteAddress;
+  Kvs_WriteAddress += KVS_RECORD_LENGTH(size);
+
+  status = MIROS_FlashProgram(address + sizeof(uint16_t), data,
+      KVS_HALF_WORDS(size));
+  if (status != HAL_OK) {
+    /* keep the log replayable, skip over the partially written value */
+    header = KVS_RECORD_HEADER(KVS_KEY_SKIP, size);
+    (void) MIROS_FlashProgram(address, &header, 1);
+    return status;
+  }
+
+  header = KVS_RECORD_HEADER(key, size);
+  status = MIROS_FlashProgram(address, &header, 1);
+  if (status != HAL_OK) {
+    return status;
+  }
+
+  Kvs_Index[key] = (size > 0) ? address : 0;
+
+  return HAL_OK;
+}
+
+/**
+ * @brief Copy the live records of @p page to the head of the log, then mark
+ * it dirty
+ *
+ * @pre Kvs_Lock is taken
+ * */
+static HAL_StatusTypeDef Kvs_Evacuate(uint32_t page) {
+  uint16_t data[KVS_HALF_WORDS(MIROS_KVS_MAX_VALUE_SIZE)];
+  uint32_t start = KVS_PAGE_ADDRESS(page);
+  uint32_t end = start + FLASH_PAGE_SIZE;
+  HAL_StatusTypeDef status;
+
+  for (uint32_t key = 1; key <= MIROS_KVS_NUM_KEYS; key++) {
+    uint32_t address = Kvs_Index[key];
+
+    if ((address >= start) && (address < end)) {
+      uint32_t size = KVS_RECORD_SIZE(KVS_READ(address));
+
+      if (size > MIROS_KVS_MAX_VALUE_SIZE) {
+        size = MIROS_KVS_MAX_VALUE_SIZE;
+      }
+
+      /* flash service can't program from a flash source */
+      memcpy(data, (const void*) (address + sizeof(uint16_t)),
+          KVS_HALF_WORDS(size) * sizeof(uint16_t));
+
+      status = Kvs_Append(key, data, size);
+      if (status != HAL_OK) {
+        return status;
+      }
+    }
+  }
+
+  Kvs_PageState[page] = KVS_PAGE_DIRTY;
+
+  return HAL_OK;
+}
+
+void MIROS_KvsInitialize(void) {
+  uint32_t order[MIROS_KVS_NUM_PAGES];
+  uint32_t used = 0;
+  uint32_t address = 0;
+
+  MIROS_SemInitialize(&Kvs_Lock, 1);
+  MIROS_SemInitialize(&Kvs_CompactRequest, 0);
+
+  for (uint32_t key = 0; key <= MIROS_KVS_NUM_KEYS; key++) {
+    Kvs_Index[key] = 0;
+  }
+  Kvs_ActivePage = KVS_NO_PAGE;
+  Kvs_WriteAddress = 0;
+
+  /* classify pages, and sort the log's pages from oldest to newest */
+  for (uint32_t page = 0; page < MIROS_KVS_NUM_PAGES; page++) {
+    uint32_t base = KVS_PAGE_ADDRESS(page);
+    uint16_t sequence = KVS_READ(base);
+
+    if ((KVS_READ(base + sizeof(uint16_t)) == KVS_PAGE_MAGIC)
+        && (sequence != KVS_ERASED)) {
+      uint32_t index = used++;
+
+      Kvs_PageState[page] = KVS_PAGE_USED;
+      Kvs_PageSequence[page] = sequence;
+
+      while ((index > 0)
+          && (Kvs_CompareSequence(Kvs_PageSequence[order[index - 1]],
+              sequence) > 0)) {
+        order[index] = order[index - 1];
+        index--;
+      }
+      order[index] = page;
+    } else if (Kvs_IsErased(base, base + FLASH_PAGE_SIZE)) {
+      Kvs_PageState[page] = KVS_PAGE_FREE;
+    } else {
+      Kvs_PageState[page] = KVS_PAGE_DIRTY;
+    }
+  }
+
+  /* replay the log, newer records override older ones */
+  for (uint32_t index = 0; index < used; index++) {
+    address = Kvs_ReplayPage(order[index]);
+  }
+
+  if (used > 0) {
+    Kvs_ActivePage = order[used - 1];
+    Kvs_RepairActivePage(address);
+  }
+
+  Kvs_CheckSpare();
+}
+
+uint32_t MIROS_KvsRead(uint32_t key, void *value, uint32_t size) {
+  uint32_t stored = 0;
+  uint32_t address;
+
+  assert_param((key > 0) && (key <= MIROS_KVS_NUM_KEYS));
+
+  MIROS_SemWait(&Kvs_Lock);
+
+  address = Kvs_Index[key];
+  if (address != 0) {
+    stored = KVS_RECORD_SIZE(KVS_READ(address));
+    memcpy(value, (const void*) (address + sizeof(uint16_t)),
+        (size < stored) ? size : stored);
+  }
+
+  MIROS_SemPost(&Kvs_Lock);
+
+  return stored;
+}
+
+HAL_StatusTypeDef MIROS_KvsWrite(uint32_t key, const void *value,
+    uint32_t size) {
+  uint16_t data[KVS_HALF_WORDS(MIROS_KVS_MAX_VALUE_SIZE)];
+  uint32_t address;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  assert_param((key > 0) && (key <= MIROS_KVS_NUM_KEYS));
+  assert_param((size > 0) && (size <= MIROS_KVS_MAX_VALUE_SIZE));
+
+  /* pad odd sized values with an erased byte */
+  data[KVS_HALF_WORDS(size) - 1] = KVS_ERASED;
+  memcpy(data, value, size);
+
+  MIROS_SemWait(&Kvs_Lock);
+
+  /* skip writing unchanged values, saves flash wear */
+  address = Kvs_Index[key];
+  if ((address == 0) || (KVS_RECORD_SIZE(KVS_READ(address)) != size)
+      || (memcmp((const void*) (address + sizeof(uint16_t)), data, size) != 0)) {
+    status = Kvs_Append(key, data, size);
+  }
+
+  MIROS_SemPost(&Kvs_Lock);
+
+  return status;
+}
+
+HAL_StatusTypeDef MIROS_KvsDelete(uint32_t key) {
+  HAL_StatusTypeDef status = HAL_OK;
+
+  assert_param((key > 0) && (key <= MIROS_KVS_NUM_KEYS));
+
+  MIROS_SemWait(&Kvs_Lock);
+
+  if (Kvs_Index[key] != 0) {
+    status = Kvs_Append(key, NULL, 0);
+  }
+
+  MIROS_SemPost(&Kvs_Lock);
+
+  return status;
+}
+
+uint32_t MIROS_KvsCompact(void) {
+  uint32_t page;
+  HAL_StatusTypeDef status;
+
+  MIROS_SemWait(&Kvs_Lock);
+
+  page = Kvs_FindPage(KVS_PAGE_DIRTY);
+  if ((page == KVS_NO_PAGE)
+      && (Kvs_CountPages(KVS_PAGE_FREE) < MIROS_KVS_SPARE_PAGES)) {
+    page = Kvs_FindOldestPage();
+    if ((page != KVS_NO_PAGE) && (Kvs_Evacuate(page) != HAL_OK)) {
+      page = KVS_NO_PAGE;
+    }
+  }
+
+  if (page != KVS_NO_PAGE) {
+    Kvs_PageState[page] = KVS_PAGE_ERASING;
+  }
+
+  MIROS_SemPost(&Kvs_Lock);
+
+  if (page == KVS_NO_PAGE) {
+    return 0;
+  }
+
+  /* the page has no live records, writers can proceed while it's erased */
+  status = MIROS_FlashErase(KVS_PAGE_ADDRESS(page), 1);
+
+  MIROS_SemWait(&Kvs_Lock);
+  Kvs_PageState[page] = (status == HAL_OK) ? KVS_PAGE_FREE : KVS_PAGE_DIRTY;
+  MIROS_SemPost(&Kvs_Lock);
+
+  return (status == HAL_OK) ? 1 : 0;
+}
+
+void MIROS_KvsTask(void) {
+  while (1) {
+    MIROS_SemWait(&Kvs_CompactRequest);
+
+    while (MIROS_KvsCompact()) {
+    }
+  }
+}
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * @file    miros_mlfq.c
+ * @brief   Multilevel feedback queue scheduling
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "priority.h"
+#include "miros_mlfq.h"
+
+#if MIROS_MLFQ_ENABLE
+
+#define MLFQ_BOTTOM_PRIORITY    (MIROS_MLFQ_TOP_PRIORITY - MIROS_MLFQ_LEVELS + 1)
+
+/**
+ * @brief Get a task's level (0 is the top level) from its priority
+ * */
+#define MLFQ_LEVEL(task)        (MIROS_MLFQ_TOP_PRIORITY - (task)->priority)
+
+static const uint16_t Mlfq_Quanta[MIROS_MLFQ_LEVELS] = MIROS_MLFQ_QUANTA;
+
+static Task_t *Mlfq_Tasks[MIROS_NUM_TASKS] = { 0 };
+static uint32_t Mlfq_NumTasks = 0;
+
+/**
+ * @brief Ticks used by each task at its current level, indexed like
+ * Mlfq_Tasks
+ * */
+static uint16_t Mlfq_Used[MIROS_NUM_TASKS] = { 0 };
+
+static uint32_t Mlfq_BoostTicks = 0;
+
+/**
+ * @brief Find a task's index in Mlfq_Tasks
+ *
+ * @param [in] task pointer to the task
+ *
+ * @return uint32_t: task's index, or #Mlfq_NumTasks if it's not attached
+ * */
+MIROS_RAMFUNC static uint32_t Mlfq_Find(const Task_t *task) {
+  uint32_t index;
+
+  for (index = 0; index < Mlfq_NumTasks; index++) {
+    if (Mlfq_Tasks[index] == task) {
+      break;
+    }
+  }
+
+  return index;
+}
+
+void MIROS_MlfqAttach(Task_t *task) {
+  uint32_t primask;
+
+  assert_param(Mlfq_NumTasks < MIROS_NUM_TASKS);
+  assert_param(MLFQ_BOTTOM_PRIORITY > MIROS_FAIR_PRIORITY);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  Mlfq_Tasks[Mlfq_NumTasks] = task;
+  Mlfq_Used[Mlfq_NumTasks] = 0;
+  Mlfq_NumTasks++;
+
+  Scheduler_SetPriority(task, MIROS_MLFQ_TOP_PRIORITY);
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+MIROS_RAMFUNC void MIROS_MlfqTick(void) {
+  Task_t *running = MIROS_GetRunningTask();
+  uint32_t index;
+
+  /* aging, move all tasks to the top level */
+  Mlfq_BoostTicks++;
+  if (Mlfq_BoostTicks >= MIROS_MLFQ_BOOST_PERIOD) {
+    Mlfq_BoostTicks = 0;
+
+    for (index = 0; index < Mlfq_NumTasks; index++) {
+      Scheduler_SetPriority(Mlfq_Tasks[index], MIROS_MLFQ_TOP_PRIORITY);
+      Mlfq_Used[index] = 0;
+    }
+  }
+
+  if ((running == NULL) || (running->state != MIROS_TASK_READY)) {
+    return;
+  }
+
+  index = Mlfq_Find(running);
+  if (index == Mlfq_NumTasks) {
+    return;
+  }
+
+  /* used its whole quantum, sink one level */
+  Mlfq_Used[index]++;
+  if (Mlfq_Used[index] >= Mlfq_Quanta[MLFQ_LEVEL(running)]) {
+    Mlfq_Used[index] = 0;
+    if (running->priority > MLFQ_BOTTOM_PRIORITY) {
+      Scheduler_SetPriority(running, running->priority - 1);
+    }
+  }
+}
+
+MIROS_RAMFUNC void MIROS_MlfqBlock(Task_t *task) {
+  uint32_t index = Mlfq_Find(task);
+
+  if (index == Mlfq_NumTasks) {
+    return;
+  }
+
+  /* blocked before using its quantum, rise one level */
+  if ((Mlfq_Used[index] < Mlfq_Quanta[MLFQ_LEVEL(task)])
+      && (task->priority < MIROS_MLFQ_TOP_PRIORITY)) {
+    Scheduler_SetPriority(task, task->priority + 1);
+  }
+  Mlfq_Used[index] = 0;
+}
+
+#endif /* MIROS_MLFQ_ENABLE */
@@ -0,0 +1,115 @@
+/******************************************************************************
+ * @file    miros_mutex.c
+ * @brief   Priority ceiling mutexes (stack resource policy)
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "priority.h"
+#include "miros_mutex.h"
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+
+/**
+ * @brief Last locked mutex, top of the locked mutexes stack
+ * */
+static Mutex_t *Mutex_Locked = NULL;
+
+void MIROS_MutexInitialize(Mutex_t *mutex, uint32_t ceiling) {
+  assert_param(ceiling != MIROS_MUTEX_IRQ_CEILING(0));
+  assert_param(ceiling < MIROS_MUTEX_IRQ_CEILING(1UL << __NVIC_PRIO_BITS));
+
+  mutex->ceiling = ceiling;
+  mutex->owner = NULL;
+  mutex->saved_ceiling = 0;
+  mutex->saved_owner = NULL;
+  mutex->saved_basepri = 0;
+  mutex->previous = NULL;
+}
+
+void MIROS_MutexLock(Mutex_t *mutex) {
+  Task_t *running = MIROS_GetRunningTask();
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  /* under SRP, a running task never finds its mutexes locked */
+  assert_param(mutex->owner == NULL);
+  assert_param(running->priority <= mutex->ceiling);
+
+  mutex->owner = running;
+  mutex->saved_ceiling = Scheduler_GetCeiling(&mutex->saved_owner);
+  mutex->saved_basepri = __get_BASEPRI();
+  mutex->previous = Mutex_Locked;
+  Mutex_Locked = mutex;
+
+  if (mutex->ceiling >= MIROS_NUM_PRIORITIES) {
+    /* mask ISRs sharing the mutex, BASEPRI_MAX never lowers the mask */
+    __set_BASEPRI_MAX(
+        (mutex->ceiling - MIROS_NUM_PRIORITIES) << (8U - __NVIC_PRIO_BITS));
+    Scheduler_SetCeiling(MIROS_NUM_PRIORITIES - 1, running);
+  } else if ((mutex->saved_owner == NULL)
+      || (mutex->ceiling > mutex->saved_ceiling)) {
+    Scheduler_SetCeiling(mutex->ceiling, running);
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+MIROS_RAMFUNC uint32_t MIROS_MutexHeld(const Task_t *task) {
+  for (Mutex_t *mutex = Mutex_Locked; mutex != NULL;
+      mutex = mutex->previous) {
+    if (mutex->owner == task) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+void MIROS_MutexUnlock(Mutex_t *mutex) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  assert_param(mutex->owner == MIROS_GetRunningTask());
+  assert_param(Mutex_Locked == mutex);
+
+  Mutex_Locked = mutex->previous;
+  mutex->owner = NULL;
+
+  Scheduler_SetCeiling(mutex->saved_ceiling, mutex->saved_owner);
+  __set_BASEPRI(mutex->saved_basepri);
+
+  /* tasks kept out by the ceiling can run now */
+  MIROS_Sched();
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+#endif /* MIROS_SCHEDULER == MIROS_SCHED_PRIORITY */
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * @file    miros_partition.c
+ * @brief   Time partitions (ARINC 653 style)
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "priority.h"
+#include "miros_partition.h"
+
+#if MIROS_PARTITION_ENABLE
+
+static const PartitionSchedule_t *Partition_Schedule = NULL;
+static uint32_t Partition_Window = 0;
+static uint32_t Partition_Remaining = 0;
+
+/**
+ * @brief Tasks that are in a partition, and round robin partitions' tasks'
+ * priorities before they were added
+ * */
+static uint32_t Partition_Tasks = 0;
+static uint32_t Partition_SavedPriority[MIROS_NUM_TASKS] = { 0 };
+
+static uint32_t Partition_SwitchCycles = 0;
+static uint32_t Partition_MaxSwitchCycles = 0;
+
+/**
+ * @brief Switch the scheduler to @p partition's tasks, or to the tasks that
+ * aren't in any partition for a spare window
+ *
+ * @param [in] partition pointer to the partition, or NULL
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Partition_Switch(const Partition_t *partition) {
+  uint32_t start = DWT->CYCCNT;
+  uint32_t tasks = ~Partition_Tasks;
+
+  if (partition != NULL) {
+    tasks = partition->tasks;
+  }
+
+  Scheduler_SetActiveTasks(tasks);
+
+  Partition_SwitchCycles = DWT->CYCCNT - start;
+  if (Partition_SwitchCycles > Partition_MaxSwitchCycles) {
+    Partition_MaxSwitchCycles = Partition_SwitchCycles;
+  }
+}
+
+void MIROS_PartitionInitialize(Partition_t *partition, uint32_t policy) {
+  partition->policy = policy;
+  partition->tasks = 0;
+}
+
+void MIROS_PartitionAddTask(Partition_t *partition, Task_t *task) {
+  uint32_t primask;
+
+  assert_param((Partition_Tasks & (1UL << task->id)) == 0);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  partition->tasks |= (1UL << task->id);
+  Partition_Tasks |= (1UL << task->id);
+
+  if (partition->policy == MIROS_PARTITION_ROUND_ROBIN) {
+    Partition_SavedPriority[task->id] = task->priority;
+    Scheduler_SetPriority(task, MIROS_PARTITION_RR_PRIORITY);
+  }
+
+  /* already running, the current window's tasks changed */
+  if (Partition_Schedule != NULL) {
+    Partition_Switch(Partition_Schedule->windows[Partition_Window].partition);
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_Sched();
+}
+
+void MIROS_PartitionRemoveTask(Partition_t *partition, Task_t *task) {
+  uint32_t primask;
+
+  assert_param((partition->tasks & (1UL << task->id)) != 0);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  partition->tasks &= ~(1UL << task->id);
+  Partition_Tasks &= ~(1UL << task->id);
+
+  if (partition->policy == MIROS_PARTITION_ROUND_ROBIN) {
+    Scheduler_SetPriority(task, Partition_SavedPriority[task->id]);
+  }
+
+  if (Partition_Schedule != NULL) {
+    Partition_Switch(Partition_Schedule->windows[Partition_Window].partition);
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_Sched();
+}
+
+void MIROS_PartitionStart(const PartitionSchedule_t *schedule) {
+  uint32_t primask;
+
+  assert_param(schedule->num_windows > 0);
+
+  /* DWT cycle counter measures switch overhead */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  Partition_Schedule = schedule;
+  Partition_Window = 0;
+  Partition_Remaining = schedule->windows[0].duration;
+  Partition_MaxSwitchCycles = 0;
+  Partition_Switch(schedule->windows[0].partition);
+
+  MIROS_Sched();
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+MIROS_RAMFUNC void MIROS_PartitionTick(void) {
+  const PartitionWindow_t *window;
+
+  if (Partition_Schedule == NULL) {
+    return;
+  }
+
+  Partition_Remaining--;
+  if (Partition_Remaining > 0) {
+    return;
+  }
+
+  /* next window, the tick calls the scheduler next */
+  Partition_Window++;
+  if (Partition_Window == Partition_Schedule->num_windows) {
+    Partition_Window = 0;
+  }
+
+  window = &Partition_Schedule->windows[Partition_Window];
+  Partition_Remaining = window->duration;
+  Partition_Switch(window->partition);
+}
+
+uint32_t MIROS_PartitionSwitchCycles(uint32_t *max) {
+  if (max != NULL) {
+    *max = Partition_MaxSwitchCycles;
+  }
+
+  return Partition_SwitchCycles;
+}
+
+#endif /* MIROS_PARTITION_ENABLE */
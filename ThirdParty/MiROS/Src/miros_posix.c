@@ -0,0 +1,1076 @@
+/******************************************************************************
+ * @file    miros_posix.c
+ * @brief   POSIX threads, semaphores, clocks and message queues on MiROS
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+#include "priority.h"
+#else
+#include "round_robin.h"
+#endif
+#include "miros_posix.h"
+
+/**
+ * @brief End of a message queue's message list, or free slots list
+ * */
+#define POSIX_MQ_NONE         0xFFU
+
+/**
+ * @brief Message header, followed by the message's data
+ *
+ * uint8_t next: next message (or free slot) index
+ * uint8_t prio: message's priority
+ * uint16_t length: message's length
+ * */
+typedef struct {
+  uint8_t next;
+  uint8_t prio;
+  uint16_t length;
+} PosixMessage_t;
+
+/**
+ * @brief Message queue
+ *
+ * char name: queue's name
+ * uint8_t * slots: message slots, reserved from the arena
+ * uint32_t slot_size: slot size, message header and data (word aligned)
+ * long maxmsg: number of slots
+ * long msgsize: maximum message length
+ * uint8_t head: first message, queued in priority order (FIFO within the
+ *    same priority)
+ * uint8_t free: first free slot
+ * uint8_t used: queue exists
+ * uint8_t unlinked: queue was unlinked, and is removed once closed
+ * uint32_t opens: number of open descriptors
+ * Semaphore_t space: number of free slots
+ * Semaphore_t messages: number of queued messages
+ * */
+typedef struct {
+  char name[MIROS_POSIX_MQ_NAME_MAX];
+  uint8_t *slots;
+  uint32_t slot_size;
+  long maxmsg;
+  long msgsize;
+  uint8_t head;
+  uint8_t free;
+  uint8_t used;
+  uint8_t unlinked;
+  uint32_t opens;
+  Semaphore_t space;
+  Semaphore_t messages;
+} PosixQueue_t;
+
+/**
+ * @brief Open message queue descriptor
+ * */
+typedef struct {
+  PosixQueue_t *queue;
+  int flags;
+} PosixDescriptor_t;
+
+static __ALIGNED(8) uint32_t
+Posix_Stacks[MIROS_POSIX_THREADS][MIROS_POSIX_THREAD_STACK_SIZE];
+static uint32_t Posix_StacksUsed = 0;
+
+static PosixQueue_t Posix_Queues[MIROS_POSIX_MQ_MAX];
+static PosixDescriptor_t Posix_Descriptors[MIROS_POSIX_MQ_OPEN_MAX];
+static uint32_t Posix_Arena[MIROS_POSIX_MQ_ARENA_SIZE / sizeof(uint32_t)];
+static uint32_t Posix_ArenaUsed = 0;
+
+/**
+ * @brief Convert milliseconds to ticks, rounded up
+ *
+ * @param [in] ms number of milliseconds
+ *
+ * @return uint32_t: number of ticks
+ * */
+static uint32_t Posix_MsToTicks(uint32_t ms) {
+  uint32_t freq = (uint32_t) HAL_GetTickFreq();
+
+  return (ms / freq) + (((ms % freq) != 0U) ? 1U : 0U);
+}
+
+/**
+ * @brief Convert a duration to ticks, rounded up
+ *
+ * @param [in] ts duration
+ *
+ * @return uint32_t: number of ticks
+ * */
+static uint32_t Posix_Ticks(const struct timespec *ts) {
+  uint32_t ms;
+
+  if ((ts->tv_sec < 0) || (ts->tv_nsec < 0)) {
+    return 0;
+  }
+
+  if (ts->tv_sec >= (time_t) (0x7FFFFFFFU / 1000U)) {
+    ms = 0x7FFFFFFFU;
+  } else {
+    ms = ((uint32_t) ts->tv_sec * 1000U)
+        + (((uint32_t) ts->tv_nsec + 999999U) / 1000000U);
+  }
+
+  return Posix_MsToTicks(ms);
+}
+
+/**
+ * @brief Number of ticks until an absolute time, 0 if it's passed
+ *
+ * The difference is taken in milliseconds, on the same clock as
+ * clock_gettime() (HAL_GetTick()), wrapping like it, then converted to ticks.
+ *
+ * @param [in] abstime absolute time, on the CLOCK_MONOTONIC clock
+ *
+ * @return uint32_t: number of ticks
+ * */
+static uint32_t Posix_TicksUntil(const struct timespec *abstime) {
+  uint32_t ms;
+  int32_t remaining;
+
+  if ((abstime->tv_sec < 0) || (abstime->tv_nsec < 0)) {
+    return 0;
+  }
+
+  ms = ((uint32_t) abstime->tv_sec * 1000U)
+      + (((uint32_t) abstime->tv_nsec + 999999U) / 1000000U);
+  remaining = (int32_t) (ms - HAL_GetTick());
+
+  return (remaining > 0) ? Posix_MsToTicks((uint32_t) remaining) : 0;
+}
+
+/**
+ * @brief Take a semaphore token within @p ticks, polled once every tick
+ *
+ * @param [in] sem pointer to the semaphore
+ * @param [in] ticks timeout, in ticks
+ *
+ * @return int: 0, or ETIMEDOUT
+ * */
+static int Posix_SemWaitTicks(Semaphore_t *sem, uint32_t ticks) {
+  while (!MIROS_SemTryWait(sem)) {
+    if (ticks == 0) {
+      return ETIMEDOUT;
+    }
+    MIROS_TaskDelay(1);
+    ticks--;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Threads' entry, runs the thread's start routine and exits with its
+ * return value
+ * */
+static void Posix_ThreadStart(void) {
+  PosixThread_t *thread = (PosixThread_t*) MIROS_GetRunningTask();
+
+  pthread_exit(thread->start_routine(thread->arg));
+}
+
+/*  Threads  */
+
+int pthread_attr_init(pthread_attr_t *attr) {
+  attr->stackaddr = NULL;
+  attr->stacksize = 0;
+  attr->detachstate = PTHREAD_CREATE_JOINABLE;
+  attr->param.sched_priority = -1;
+
+  return 0;
+}
+
+int pthread_attr_destroy(pthread_attr_t *attr) {
+  (void) attr;
+
+  return 0;
+}
+
+int pthread_attr_setstack(pthread_attr_t *attr, void *stackaddr,
+    size_t stacksize) {
+  if ((stackaddr == NULL)
+      || (stacksize < (sizeof(PosixThread_t) + PTHREAD_STACK_MIN))) {
+    return EINVAL;
+  }
+
+  attr->stackaddr = stackaddr;
+  attr->stacksize = stacksize;
+
+  return 0;
+}
+
+int pthread_attr_setdetachstate(pthread_attr_t *attr, int detachstate) {
+  if ((detachstate != PTHREAD_CREATE_JOINABLE)
+      && (detachstate != PTHREAD_CREATE_DETACHED)) {
+    return EINVAL;
+  }
+
+  attr->detachstate = detachstate;
+
+  return 0;
+}
+
+int pthread_attr_setschedparam(pthread_attr_t *attr,
+    const struct sched_param *param) {
+  if ((param->sched_priority < -1)
+      || (param->sched_priority >= MIROS_NUM_PRIORITIES)) {
+    return EINVAL;
+  }
+
+  attr->param.sched_priority = param->sched_priority;
+
+  return 0;
+}
+
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+    void *(*start_routine)(void*), void *arg) {
+  TaskAttributes_t attributes = { 0 };
+  pthread_attr_t defaults;
+  Task_t *creator = MIROS_GetRunningTask();
+  uint8_t *stack;
+  size_t stack_size;
+  uintptr_t top;
+  uint32_t pooled = 0;
+  PosixThread_t *cb;
+  HAL_StatusTypeDef status;
+  uint32_t primask;
+
+  if ((thread == NULL) || (start_routine == NULL)) {
+    return EINVAL;
+  }
+
+  if (attr == NULL) {
+    (void) pthread_attr_init(&defaults);
+    attr = &defaults;
+  }
+
+  /* the attributes' members may be set directly, not through the setters */
+  if ((attr->param.sched_priority < -1)
+      || (attr->param.sched_priority >= MIROS_NUM_PRIORITIES)) {
+    return EINVAL;
+  }
+
+  attributes.priority = MIROS_DEFAULT_PRIORITY;
+  if (attr->param.sched_priority >= 0) {
+    attributes.priority = (uint32_t) attr->param.sched_priority;
+  } else if (creator != NULL) {
+    attributes.priority = creator->priority;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  stack = attr->stackaddr;
+  stack_size = attr->stacksize;
+  if (stack == NULL) {
+    if (Posix_StacksUsed >= MIROS_POSIX_THREADS) {
+      MIROS_CRITICAL_EXIT(primask);
+      return EAGAIN;
+    }
+    stack = (uint8_t*) Posix_Stacks[Posix_StacksUsed++];
+    stack_size = sizeof(Posix_Stacks[0]);
+    pooled = 1;
+  }
+
+  /* control block at the top of the stack, the task's stack beneath it */
+  top = ((uintptr_t) stack + stack_size - sizeof(PosixThread_t))
+      & ~(uintptr_t) 7U;
+  cb = (PosixThread_t*) top;
+  cb->start_routine = start_routine;
+  cb->arg = arg;
+  cb->retval = NULL;
+  cb->detached = (attr->detachstate == PTHREAD_CREATE_DETACHED);
+  MIROS_SemInitialize(&cb->done, 0);
+
+  status = MIROS_TaskInitializeWithAttributes(&cb->task, Posix_ThreadStart,
+      (uint32_t*) stack, (top - (uintptr_t) stack) / sizeof(uint32_t),
+      &attributes);
+  if ((status != HAL_OK) && pooled) {
+    Posix_StacksUsed--;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (status != HAL_OK) {
+    return EAGAIN;
+  }
+
+  *thread = cb;
+
+  /* may preempt its creator */
+  MIROS_Sched();
+
+  return 0;
+}
+
+int pthread_join(pthread_t thread, void **retval) {
+  if (thread == NULL) {
+    return ESRCH;
+  }
+
+  if (thread->detached) {
+    return EINVAL;
+  }
+
+  if (thread == pthread_self()) {
+    return EDEADLK;
+  }
+
+  MIROS_SemWait(&thread->done);
+  thread->detached = 1;
+
+  if (retval != NULL) {
+    *retval = thread->retval;
+  }
+
+  return 0;
+}
+
+int pthread_detach(pthread_t thread) {
+  if (thread == NULL) {
+    return ESRCH;
+  }
+
+  thread->detached = 1;
+
+  return 0;
+}
+
+void pthread_exit(void *retval) {
+  PosixThread_t *self = pthread_self();
+  uint32_t primask;
+
+  self->retval = retval;
+  if (!self->detached) {
+    MIROS_SemPost(&self->done);
+  }
+
+  /* MiROS tasks don't end, the thread stays blocked */
+  for (;;) {
+    MIROS_CRITICAL_ENTER(primask);
+    MIROS_TaskBlock();
+    MIROS_CRITICAL_EXIT(primask);
+  }
+}
+
+pthread_t pthread_self(void) {
+  return (pthread_t) MIROS_GetRunningTask();
+}
+
+int pthread_equal(pthread_t t1, pthread_t t2) {
+  return (t1 == t2);
+}
+
+int sched_yield(void) {
+  MIROS_Sched();
+
+  return 0;
+}
+
+/*  Mutexes  */
+
+int pthread_mutexattr_init(pthread_mutexattr_t *attr) {
+  attr->type = PTHREAD_MUTEX_DEFAULT;
+
+  return 0;
+}
+
+int pthread_mutexattr_destroy(pthread_mutexattr_t *attr) {
+  (void) attr;
+
+  return 0;
+}
+
+int pthread_mutexattr_settype(pthread_mutexattr_t *attr, int type) {
+  if ((type != PTHREAD_MUTEX_NORMAL) && (type != PTHREAD_MUTEX_RECURSIVE)
+      && (type != PTHREAD_MUTEX_ERRORCHECK)) {
+    return EINVAL;
+  }
+
+  attr->type = type;
+
+  return 0;
+}
+
+int pthread_mutex_init(pthread_mutex_t *mutex,
+    const pthread_mutexattr_t *attr) {
+  MIROS_SemInitialize(&mutex->lock, 1);
+  mutex->owner = NULL;
+  mutex->type = (attr == NULL) ? PTHREAD_MUTEX_DEFAULT : attr->type;
+  mutex->count = 0;
+
+  return 0;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t *mutex) {
+  return (mutex->owner == NULL) ? 0 : EBUSY;
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+  Task_t *self = MIROS_GetRunningTask();
+
+  /* only the owner sets the owner to itself */
+  if (mutex->owner == self) {
+    if (mutex->type != PTHREAD_MUTEX_RECURSIVE) {
+      return EDEADLK;
+    }
+    mutex->count++;
+    return 0;
+  }
+
+  MIROS_SemWait(&mutex->lock);
+  mutex->owner = self;
+  mutex->count = 1;
+
+  return 0;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex) {
+  Task_t *self = MIROS_GetRunningTask();
+
+  if ((mutex->owner == self) && (mutex->type == PTHREAD_MUTEX_RECURSIVE)) {
+    mutex->count++;
+    return 0;
+  }
+
+  if (!MIROS_SemTryWait(&mutex->lock)) {
+    return EBUSY;
+  }
+
+  mutex->owner = self;
+  mutex->count = 1;
+
+  return 0;
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex) {
+  if (mutex->owner != MIROS_GetRunningTask()) {
+    return EPERM;
+  }
+
+  if (--mutex->count > 0) {
+    return 0;
+  }
+
+  mutex->owner = NULL;
+  MIROS_SemPost(&mutex->lock);
+
+  return 0;
+}
+
+/*  Condition variables  */
+
+/**
+ * @brief Wait on a condition variable, until signaled, or until @p abstime
+ * if it's not NULL
+ *
+ * @param [in] cond pointer to the condition variable
+ * @param [in] mutex pointer to the mutex, locked by the caller
+ * @param [in] abstime absolute timeout, or NULL
+ *
+ * @return int: 0, EPERM (mutex isn't locked by the caller), or ETIMEDOUT
+ * */
+static int Posix_CondWait(pthread_cond_t *cond, pthread_mutex_t *mutex,
+    const struct timespec *abstime) {
+  Task_t *self = MIROS_GetRunningTask();
+  uint32_t ticks = 0;
+  uint32_t count;
+  int status = 0;
+  uint32_t primask;
+
+  if (mutex->owner != self) {
+    return EPERM;
+  }
+
+  if (abstime != NULL) {
+    ticks = Posix_TicksUntil(abstime);
+  }
+
+  /* count the waiter before releasing the mutex, so no signal is missed */
+  MIROS_CRITICAL_ENTER(primask);
+  cond->waiters++;
+  MIROS_CRITICAL_EXIT(primask);
+
+  count = mutex->count;
+  mutex->count = 1;
+  (void) pthread_mutex_unlock(mutex);
+
+  if (abstime == NULL) {
+    MIROS_SemWait(&cond->wait);
+  } else {
+    while (!MIROS_SemTryWait(&cond->wait)) {
+      if (ticks == 0) {
+        /* a signal may still be posted for this waiter */
+        MIROS_CRITICAL_ENTER(primask);
+        if (!MIROS_SemTryWait(&cond->wait)) {
+          cond->waiters--;
+          status = ETIMEDOUT;
+        }
+        MIROS_CRITICAL_EXIT(primask);
+        break;
+      }
+      MIROS_TaskDelay(1);
+      ticks--;
+    }
+  }
+
+  MIROS_SemWait(&mutex->lock);
+  mutex->owner = self;
+  mutex->count = count;
+
+  return status;
+}
+
+int pthread_condattr_init(pthread_condattr_t *attr) {
+  attr->unused = 0;
+
+  return 0;
+}
+
+int pthread_condattr_destroy(pthread_condattr_t *attr) {
+  (void) attr;
+
+  return 0;
+}
+
+int pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr) {
+  (void) attr;
+
+  MIROS_SemInitialize(&cond->wait, 0);
+  cond->waiters = 0;
+
+  return 0;
+}
+
+int pthread_cond_destroy(pthread_cond_t *cond) {
+  return (cond->waiters == 0) ? 0 : EBUSY;
+}
+
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+  return Posix_CondWait(cond, mutex, NULL);
+}
+
+int pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex,
+    const struct timespec *abstime) {
+  if (abstime == NULL) {
+    return EINVAL;
+  }
+
+  return Posix_CondWait(cond, mutex, abstime);
+}
+
+int pthread_cond_signal(pthread_cond_t *cond) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+  if (cond->waiters > 0) {
+    cond->waiters--;
+    MIROS_SemPost(&cond->wait);
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  return 0;
+}
+
+int pthread_cond_broadcast(pthread_cond_t *cond) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+  while (cond->waiters > 0) {
+    cond->waiters--;
+    MIROS_SemPost(&cond->wait);
+  }
+  MIROS_CRITICAL_EXIT(primask);
+
+  return 0;
+}
+
+/*  Semaphores  */
+
+int sem_init(sem_t *sem, int pshared, unsigned int value) {
+  (void) pshared;
+
+  if (value > SEM_VALUE_MAX) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  MIROS_SemInitialize(&sem->sem, value);
+
+  return 0;
+}
+
+int sem_destroy(sem_t *sem) {
+  if (sem->sem.head != NULL) {
+    errno = EBUSY;
+    return -1;
+  }
+
+  return 0;
+}
+
+int sem_wait(sem_t *sem) {
+  MIROS_SemWait(&sem->sem);
+
+  return 0;
+}
+
+int sem_trywait(sem_t *sem) {
+  if (!MIROS_SemTryWait(&sem->sem)) {
+    errno = EAGAIN;
+    return -1;
+  }
+
+  return 0;
+}
+
+int sem_timedwait(sem_t *sem, const struct timespec *abstime) {
+  if (Posix_SemWaitTicks(&sem->sem, Posix_TicksUntil(abstime)) != 0) {
+    errno = ETIMEDOUT;
+    return -1;
+  }
+
+  return 0;
+}
+
+int sem_post(sem_t *sem) {
+  if (sem->sem.count >= SEM_VALUE_MAX) {
+    errno = EOVERFLOW;
+    return -1;
+  }
+
+  MIROS_SemPost(&sem->sem);
+
+  return 0;
+}
+
+int sem_getvalue(sem_t *sem, int *value) {
+  *value = (int) sem->sem.count;
+
+  return 0;
+}
+
+/*  Clocks  */
+
+int clock_gettime(clockid_t clock_id, struct timespec *tp) {
+  uint32_t ms = HAL_GetTick();
+
+  if ((clock_id != CLOCK_MONOTONIC) && (clock_id != CLOCK_REALTIME)) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  tp->tv_sec = (time_t) (ms / 1000U);
+  tp->tv_nsec = (long) ((ms % 1000U) * 1000000U);
+
+  return 0;
+}
+
+int clock_nanosleep(clockid_t clock_id, int flags,
+    const struct timespec *request, struct timespec *remain) {
+  uint32_t ticks;
+
+  if (((clock_id != CLOCK_MONOTONIC) && (clock_id != CLOCK_REALTIME))
+      || (request->tv_nsec < 0) || (request->tv_nsec >= 1000000000L)) {
+    return EINVAL;
+  }
+
+  if (flags & TIMER_ABSTIME) {
+    ticks = Posix_TicksUntil(request);
+  } else {
+    ticks = Posix_Ticks(request);
+    if (remain != NULL) {
+      remain->tv_sec = 0;
+      remain->tv_nsec = 0;
+    }
+  }
+
+  MIROS_TaskDelay(ticks);
+
+  return 0;
+}
+
+int nanosleep(const struct timespec *request, struct timespec *remain) {
+  int status = clock_nanosleep(CLOCK_MONOTONIC, 0, request, remain);
+
+  if (status != 0) {
+    errno = status;
+    return -1;
+  }
+
+  return 0;
+}
+
+/*  Message queues  */
+
+/**
+ * @brief Get message slot @p index of @p queue
+ * */
+static PosixMessage_t* Posix_Message(PosixQueue_t *queue, uint8_t index) {
+  return (PosixMessage_t*) (queue->slots + (index * queue->slot_size));
+}
+
+/**
+ * @brief Get the open descriptor @p mqdes, NULL if it's not open
+ * */
+static PosixDescriptor_t* Posix_Descriptor(mqd_t mqdes) {
+  if ((mqdes < 0) || (mqdes >= MIROS_POSIX_MQ_OPEN_MAX)
+      || (Posix_Descriptors[mqdes].queue == NULL)) {
+    return NULL;
+  }
+
+  return &Posix_Descriptors[mqdes];
+}
+
+/**
+ * @brief Take a semaphore token for a message queue operation, following
+ * the descriptor's O_NONBLOCK flag, or within @p abstime if it's not NULL
+ *
+ * @return int: 0, EAGAIN or ETIMEDOUT
+ * */
+static int Posix_QueueWait(Semaphore_t *sem, int flags,
+    const struct timespec *abstime) {
+  if (flags & O_NONBLOCK) {
+    return MIROS_SemTryWait(sem) ? 0 : EAGAIN;
+  }
+
+  if (abstime != NULL) {
+    return Posix_SemWaitTicks(sem, Posix_TicksUntil(abstime));
+  }
+
+  MIROS_SemWait(sem);
+
+  return 0;
+}
+
+mqd_t mq_open(const char *name, int oflag, ...) {
+  struct mq_attr *attr = NULL;
+  PosixQueue_t *queue = NULL;
+  PosixQueue_t *empty = NULL;
+  mqd_t mqdes = -1;
+  int error = 0;
+  va_list args;
+  uint32_t primask;
+
+  if ((name == NULL) || (strlen(name) >= MIROS_POSIX_MQ_NAME_MAX)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+
+  if (oflag & O_CREAT) {
+    va_start(args, oflag);
+    (void) va_arg(args, mode_t);
+    attr = va_arg(args, struct mq_attr*);
+    va_end(args);
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  for (uint32_t i = 0; i < MIROS_POSIX_MQ_MAX; i++) {
+    if (Posix_Queues[i].used && !Posix_Queues[i].unlinked
+        && (strcmp(Posix_Queues[i].name, name) == 0)) {
+      queue = &Posix_Queues[i];
+    } else if (!Posix_Queues[i].used && (empty == NULL)) {
+      empty = &Posix_Queues[i];
+    }
+  }
+
+  for (mqd_t i = 0; i < MIROS_POSIX_MQ_OPEN_MAX; i++) {
+    if (Posix_Descriptors[i].queue == NULL) {
+      mqdes = i;
+      break;
+    }
+  }
+
+  if (mqdes < 0) {
+    error = EMFILE;
+  } else if (queue != NULL) {
+    if ((oflag & O_CREAT) && (oflag & O_EXCL)) {
+      error = EEXIST;
+    }
+  } else if (!(oflag & O_CREAT)) {
+    error = ENOENT;
+  } else if (empty == NULL) {
+    error = ENFILE;
+  } else {
+    long maxmsg = (attr == NULL) ? MIROS_POSIX_MQ_MAXMSG : attr->mq_maxmsg;
+    long msgsize = (attr == NULL) ? MIROS_POSIX_MQ_MSGSIZE : attr->mq_msgsize;
+    uint32_t slot_size = (sizeof(PosixMessage_t) + (uint32_t) msgsize + 3U)
+        & ~3U;
+
+    if ((maxmsg <= 0) || (maxmsg >= POSIX_MQ_NONE) || (msgsize <= 0)
+        || (msgsize > UINT16_MAX)) {
+      error = EINVAL;
+    } else if ((Posix_ArenaUsed + ((uint32_t) maxmsg * slot_size))
+        > sizeof(Posix_Arena)) {
+      error = ENOSPC;
+    } else {
+      queue = empty;
+      strcpy(queue->name, name);
+      queue->slots = (uint8_t*) Posix_Arena + Posix_ArenaUsed;
+      queue->slot_size = slot_size;
+      queue->maxmsg = maxmsg;
+      queue->msgsize = msgsize;
+      queue->head = POSIX_MQ_NONE;
+      queue->used = 1;
+      queue->unlinked = 0;
+      queue->opens = 0;
+      MIROS_SemInitialize(&queue->space, (uint32_t) maxmsg);
+      MIROS_SemInitialize(&queue->messages, 0);
+      Posix_ArenaUsed += (uint32_t) maxmsg * slot_size;
+
+      /* all slots are free */
+      queue->free = 0;
+      for (uint8_t i = 0; i < maxmsg; i++) {
+        Posix_Message(queue, i)->next =
+            ((i + 1) < maxmsg) ? (uint8_t) (i + 1) : POSIX_MQ_NONE;
+      }
+    }
+  }
+
+  if (error == 0) {
+    queue->opens++;
+    Posix_Descriptors[mqdes].queue = queue;
+    Posix_Descriptors[mqdes].flags = oflag;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  return mqdes;
+}
+
+int mq_close(mqd_t mqdes) {
+  PosixDescriptor_t *descriptor;
+  PosixQueue_t *queue;
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  descriptor = Posix_Descriptor(mqdes);
+  if (descriptor == NULL) {
+    MIROS_CRITICAL_EXIT(primask);
+    errno = EBADF;
+    return -1;
+  }
+
+  queue = descriptor->queue;
+  descriptor->queue = NULL;
+  if ((--queue->opens == 0) && queue->unlinked) {
+    queue->used = 0;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return 0;
+}
+
+int mq_unlink(const char *name) {
+  int error = ENOENT;
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  for (uint32_t i = 0; i < MIROS_POSIX_MQ_MAX; i++) {
+    PosixQueue_t *queue = &Posix_Queues[i];
+
+    if (queue->used && !queue->unlinked
+        && (strcmp(queue->name, name) == 0)) {
+      /* removed once it's closed by all */
+      queue->unlinked = 1;
+      if (queue->opens == 0) {
+        queue->used = 0;
+      }
+      error = 0;
+      break;
+    }
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  return 0;
+}
+
+int mq_timedsend(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
+    unsigned int msg_prio, const struct timespec *abstime) {
+  PosixDescriptor_t *descriptor = Posix_Descriptor(mqdes);
+  PosixQueue_t *queue;
+  PosixMessage_t *message;
+  uint8_t *link;
+  uint8_t index;
+  int error;
+  uint32_t primask;
+
+  if ((descriptor == NULL)
+      || ((descriptor->flags & O_ACCMODE) == O_RDONLY)) {
+    errno = EBADF;
+    return -1;
+  }
+
+  queue = descriptor->queue;
+  if (msg_len > (size_t) queue->msgsize) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  if (msg_prio >= MQ_PRIO_MAX) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  error = Posix_QueueWait(&queue->space, descriptor->flags, abstime);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  /* a free slot is reserved, the free list isn't empty */
+  index = queue->free;
+  message = Posix_Message(queue, index);
+  queue->free = message->next;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  /* the slot is off both lists, it's filled with interrupts enabled */
+  message->prio = (uint8_t) msg_prio;
+  message->length = (uint16_t) msg_len;
+  memcpy(message + 1, msg_ptr, msg_len);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  /* insert after the messages of the same, or higher, priority */
+  link = &queue->head;
+  while ((*link != POSIX_MQ_NONE)
+      && (Posix_Message(queue, *link)->prio >= message->prio)) {
+    link = &Posix_Message(queue, *link)->next;
+  }
+  message->next = *link;
+  *link = index;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_SemPost(&queue->messages);
+
+  return 0;
+}
+
+int mq_send(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
+    unsigned int msg_prio) {
+  return mq_timedsend(mqdes, msg_ptr, msg_len, msg_prio, NULL);
+}
+
+ssize_t mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
+    unsigned int *msg_prio, const struct timespec *abstime) {
+  PosixDescriptor_t *descriptor = Posix_Descriptor(mqdes);
+  PosixQueue_t *queue;
+  PosixMessage_t *message;
+  uint8_t index;
+  ssize_t length;
+  int error;
+  uint32_t primask;
+
+  if ((descriptor == NULL)
+      || ((descriptor->flags & O_ACCMODE) == O_WRONLY)) {
+    errno = EBADF;
+    return -1;
+  }
+
+  queue = descriptor->queue;
+  if (msg_len < (size_t) queue->msgsize) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  error = Posix_QueueWait(&queue->messages, descriptor->flags, abstime);
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  index = queue->head;
+  message = Posix_Message(queue, index);
+  queue->head = message->next;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  /* the message is off both lists, it's copied with interrupts enabled */
+  length = message->length;
+  memcpy(msg_ptr, message + 1, message->length);
+  if (msg_prio != NULL) {
+    *msg_prio = message->prio;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  message->next = queue->free;
+  queue->free = index;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  MIROS_SemPost(&queue->space);
+
+  return length;
+}
+
+ssize_t mq_receive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
+    unsigned int *msg_prio) {
+  return mq_timedreceive(mqdes, msg_ptr, msg_len, msg_prio, NULL);
+}
+
+int mq_getattr(mqd_t mqdes, struct mq_attr *attr) {
+  PosixDescriptor_t *descriptor = Posix_Descriptor(mqdes);
+
+  if (descriptor == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+
+  attr->mq_flags = descriptor->flags & O_NONBLOCK;
+  attr->mq_maxmsg = descriptor->queue->maxmsg;
+  attr->mq_msgsize = descriptor->queue->msgsize;
+  attr->mq_curmsgs = (long) descriptor->queue->messages.count;
+
+  return 0;
+}
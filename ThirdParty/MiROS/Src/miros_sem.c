@@ -0,0 +1,107 @@
+/******************************************************************************
+ * @file    miros_sem.c
+ * @brief   MiROS counting semaphore
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+
+MIROS_RAMFUNC void MIROS_SemInitialize(Semaphore_t *sem, uint32_t count) {
+  sem->count = count;
+  sem->head = NULL;
+  sem->tail = NULL;
+}
+
+MIROS_RAMFUNC void MIROS_SemWait(Semaphore_t *sem) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (sem->count > 0) {
+    sem->count--;
+  } else {
+    Task_t *task = MIROS_GetRunningTask();
+
+    /* add running task to the tail of the wait queue */
+    task->next = NULL;
+    if (sem->tail == NULL) {
+      sem->head = task;
+    } else {
+      sem->tail->next = task;
+    }
+    sem->tail = task;
+
+    /**
+     * The task is switched out when the critical section is exited, and
+     * resumes after #MIROS_SemPost() hands it the token.
+     * */
+    MIROS_TaskBlock();
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+uint32_t MIROS_SemTryWait(Semaphore_t *sem) {
+  uint32_t primask;
+  uint32_t taken = 0;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (sem->count > 0) {
+    sem->count--;
+    taken = 1;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return taken;
+}
+
+MIROS_RAMFUNC void MIROS_SemPost(Semaphore_t *sem) {
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (sem->head != NULL) {
+    Task_t *task = sem->head;
+
+    /* hand the token to the first waiting task */
+    sem->head = task->next;
+    if (sem->head == NULL) {
+      sem->tail = NULL;
+    }
+    task->next = NULL;
+
+    MIROS_TaskUnblock(task);
+  } else {
+    sem->count++;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
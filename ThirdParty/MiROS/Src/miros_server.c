@@ -0,0 +1,167 @@
+/******************************************************************************
+ * @file    miros_server.c
+ * @brief   Sporadic servers for aperiodic tasks
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "priority.h"
+#include "miros_server.h"
+
+#if MIROS_SERVER_ENABLE
+
+static Server_t *Server_List = NULL;
+
+/**
+ * @brief Servers' time base, in OS ticks
+ * */
+static uint32_t Server_Ticks = 0;
+
+/**
+ * @brief Set the priority of all tasks attached to @p server
+ *
+ * @param [in] server pointer to the server
+ * @param [in] priority tasks' new priority
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Server_SetPriority(Server_t *server,
+    uint32_t priority) {
+  for (uint32_t index = 0; index < server->num_tasks; index++) {
+    Scheduler_SetPriority(server->tasks[index], priority);
+  }
+}
+
+void MIROS_ServerInitialize(Server_t *server, uint32_t priority,
+    uint32_t capacity, uint32_t period) {
+  assert_param(priority < MIROS_NUM_PRIORITIES);
+  assert_param(capacity > 0);
+  assert_param(period > 0);
+
+  server->priority = priority;
+  server->capacity_us = capacity;
+  server->capacity = capacity * (SystemCoreClock / 1000000U);
+  server->period = period;
+  server->budget = server->capacity;
+  server->head = 0;
+  server->count = 0;
+  server->num_tasks = 0;
+
+  server->next = Server_List;
+  Server_List = server;
+}
+
+void MIROS_ServerAttach(Server_t *server, Task_t *task) {
+  uint32_t primask;
+
+  assert_param(server->num_tasks < MIROS_SERVER_MAX_TASKS);
+  assert_param(task->period == 0);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  task->server = server;
+  server->tasks[server->num_tasks] = task;
+  server->num_tasks++;
+
+  Scheduler_SetPriority(task,
+      (server->budget > 0) ? server->priority
+                           : MIROS_SERVER_BACKGROUND_PRIORITY);
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+void MIROS_ServerStart(void) {
+  for (Server_t *server = Server_List; server != NULL; server =
+      server->next) {
+    server->capacity = server->capacity_us * (SystemCoreClock / 1000000U);
+    server->budget = server->capacity;
+    server->head = 0;
+    server->count = 0;
+    Server_SetPriority(server, server->priority);
+  }
+}
+
+MIROS_RAMFUNC void MIROS_ServerCharge(Server_t *server, uint32_t cycles) {
+  uint32_t tick = Server_Ticks + server->period;
+  ServerReplenishment_t *last;
+
+  /* background execution is not charged */
+  if (server->budget == 0) {
+    return;
+  }
+
+  if (cycles > server->budget) {
+    cycles = server->budget;
+  }
+
+  server->budget -= cycles;
+
+  /* give the used budget back one period later */
+  last = &server->replenishments[(server->head + server->count - 1)
+      % MIROS_SERVER_REPLENISHMENTS];
+  if ((server->count > 0)
+      && ((last->tick == tick)
+          || (server->count == MIROS_SERVER_REPLENISHMENTS))) {
+    /* merge, delaying the last replenishment if needed */
+    last->tick = tick;
+    last->amount += cycles;
+  } else {
+    last = &server->replenishments[(server->head + server->count)
+        % MIROS_SERVER_REPLENISHMENTS];
+    last->tick = tick;
+    last->amount = cycles;
+    server->count++;
+  }
+
+  if (server->budget == 0) {
+    Server_SetPriority(server, MIROS_SERVER_BACKGROUND_PRIORITY);
+  }
+}
+
+MIROS_RAMFUNC void MIROS_ServerTick(void) {
+  Server_Ticks++;
+
+  for (Server_t *server = Server_List; server != NULL; server =
+      server->next) {
+    uint32_t exhausted = (server->budget == 0);
+
+    while ((server->count > 0)
+        && ((int32_t) (Server_Ticks - server->replenishments[server->head].tick)
+            >= 0)) {
+      server->budget += server->replenishments[server->head].amount;
+      server->head = (server->head + 1) % MIROS_SERVER_REPLENISHMENTS;
+      server->count--;
+    }
+
+    if (exhausted && (server->budget > 0)) {
+      Server_SetPriority(server, server->priority);
+    }
+  }
+}
+
+#endif /* MIROS_SERVER_ENABLE */
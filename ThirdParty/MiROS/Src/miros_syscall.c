@@ -0,0 +1,171 @@
+/******************************************************************************
+ * @file    miros_syscall.c
+ * @brief   System calls, for unprivileged tasks
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+#include "miros_mutex.h"
+#endif
+#if MIROS_TRACE_ENABLE
+#include "miros_trace.h"
+#endif
+#include "miros_syscall.h"
+
+/**
+ * @brief System call function, takes the caller's R0 and R1, returns the
+ * value of the caller's R0
+ * */
+typedef uint32_t (*Syscall_t)(uint32_t arg0, uint32_t arg1);
+
+static uint32_t Syscall_Null(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  return arg0;
+}
+
+static uint32_t Syscall_TaskDelay(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  MIROS_TaskDelay(arg0);
+  return 0;
+}
+
+static uint32_t Syscall_TaskWaitPeriod(uint32_t arg0, uint32_t arg1) {
+  (void) arg0;
+  (void) arg1;
+  MIROS_TaskWaitPeriod();
+  return 0;
+}
+
+static uint32_t Syscall_SemWait(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  MIROS_SemWait((Semaphore_t*) arg0);
+  return 0;
+}
+
+static uint32_t Syscall_SemTryWait(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  return MIROS_SemTryWait((Semaphore_t*) arg0);
+}
+
+static uint32_t Syscall_SemPost(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  MIROS_SemPost((Semaphore_t*) arg0);
+  return 0;
+}
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+static uint32_t Syscall_MutexLock(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  MIROS_MutexLock((Mutex_t*) arg0);
+  return 0;
+}
+
+static uint32_t Syscall_MutexUnlock(uint32_t arg0, uint32_t arg1) {
+  (void) arg1;
+  MIROS_MutexUnlock((Mutex_t*) arg0);
+  return 0;
+}
+#endif
+
+#if MIROS_TRACE_ENABLE
+static uint32_t Syscall_TraceRecord(uint32_t arg0, uint32_t arg1) {
+  MIROS_TraceRecord((uint16_t) arg0, (uint16_t) arg1);
+  return 0;
+}
+#endif
+
+static uint32_t Syscall_Start(uint32_t arg0, uint32_t arg1) {
+  (void) arg0;
+  (void) arg1;
+  MIROS_Launch();
+  return MIROS_SYSCALL_INVALID;
+}
+
+/**
+ * @brief Dispatch table, indexed by system call number. Calls that are not
+ * configured are left NULL.
+ * */
+static const Syscall_t Syscall_Table[MIROS_NUM_SYSCALLS] = {
+  [MIROS_SYSCALL_NULL] = Syscall_Null,
+  [MIROS_SYSCALL_TASK_DELAY] = Syscall_TaskDelay,
+  [MIROS_SYSCALL_TASK_WAIT_PERIOD] = Syscall_TaskWaitPeriod,
+  [MIROS_SYSCALL_SEM_WAIT] = Syscall_SemWait,
+  [MIROS_SYSCALL_SEM_TRY_WAIT] = Syscall_SemTryWait,
+  [MIROS_SYSCALL_SEM_POST] = Syscall_SemPost,
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+  [MIROS_SYSCALL_MUTEX_LOCK] = Syscall_MutexLock,
+  [MIROS_SYSCALL_MUTEX_UNLOCK] = Syscall_MutexUnlock,
+#endif
+#if MIROS_TRACE_ENABLE
+  [MIROS_SYSCALL_TRACE_RECORD] = Syscall_TraceRecord,
+#endif
+  [MIROS_SYSCALL_START] = Syscall_Start,
+};
+
+void MIROS_SyscallDispatch(uint32_t *frame) {
+  /* SVC immediate, low byte of the instruction before the stacked PC */
+  uint32_t number = ((const uint8_t*) frame[6])[-2];
+
+  if ((number < MIROS_NUM_SYSCALLS) && (Syscall_Table[number] != NULL)) {
+    frame[0] = Syscall_Table[number](frame[0], frame[1]);
+  } else {
+    frame[0] = MIROS_SYSCALL_INVALID;
+  }
+}
+
+/**
+ * @brief SVC exception handler, passes the stacked exception frame (on MSP
+ * or PSP, depending on EXC_RETURN) to #MIROS_SyscallDispatch()
+ * */
+__attribute__((naked)) void SVC_Handler(void) {
+  __asm volatile (
+      "TST   LR, #4\n\t"
+      "ITE   EQ\n\t"
+      "MRSEQ R0, MSP\n\t"
+      "MRSNE R0, PSP\n\t"
+      "B     MIROS_SyscallDispatch\n\t"
+  );
+}
+
+void MIROS_SyscallMeasure(uint32_t *direct, uint32_t *svc) {
+  volatile Syscall_t call = Syscall_Table[MIROS_SYSCALL_NULL];
+  uint32_t start;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  (void) call(0, 0);
+  *direct = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  (void) MIROS_SVC(MIROS_SYSCALL_NULL, 0, 0);
+  *svc = DWT->CYCCNT - start;
+}
@@ -0,0 +1,147 @@
+/******************************************************************************
+ * @file    miros_timer.c
+ * @brief   Software timers, ticked by the kernel tick
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_timer.h"
+
+static Timer_t *Timer_Armed = NULL;
+
+/**
+ * @brief Remove @p timer from the armed list, in a critical section
+ * */
+static void Timer_Unlink(Timer_t *timer) {
+  Timer_t **link = &Timer_Armed;
+
+  while (*link != timer) {
+    link = &(*link)->next;
+  }
+  *link = timer->next;
+
+  timer->next = NULL;
+  timer->armed = 0;
+}
+
+void MIROS_TimerInitialize(Timer_t *timer, TimerCallback_t callback,
+    void *context) {
+  assert_param(callback != NULL);
+
+  timer->next = NULL;
+  timer->callback = callback;
+  timer->context = context;
+  timer->remaining = 0;
+  timer->period = 0;
+  timer->armed = 0;
+  timer->next_expired = NULL;
+  timer->pending = 0;
+}
+
+void MIROS_TimerStart(Timer_t *timer, uint32_t ticks, uint32_t period) {
+  uint32_t primask;
+
+  assert_param(ticks > 0);
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  timer->remaining = ticks;
+  timer->period = period;
+  timer->pending = 0;
+
+  if (!timer->armed) {
+    timer->next = Timer_Armed;
+    Timer_Armed = timer;
+    timer->armed = 1;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+uint32_t MIROS_TimerStop(Timer_t *timer) {
+  uint32_t primask;
+  uint32_t armed;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  armed = timer->armed | timer->pending;
+  if (timer->armed) {
+    Timer_Unlink(timer);
+  }
+  timer->pending = 0;
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return armed;
+}
+
+MIROS_RAMFUNC void MIROS_TimerTick(void) {
+  Timer_t *expired = NULL;
+  Timer_t **tail = &expired;
+  Timer_t **link = &Timer_Armed;
+  uint32_t primask;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  /* collect expired timers, before any callback changes the armed list */
+  while (*link != NULL) {
+    Timer_t *timer = *link;
+
+    timer->remaining--;
+    if (timer->remaining == 0) {
+      if (timer->period > 0) {
+        timer->remaining = timer->period;
+        link = &timer->next;
+      } else {
+        *link = timer->next;
+        timer->next = NULL;
+        timer->armed = 0;
+      }
+
+      timer->pending = 1;
+      timer->next_expired = NULL;
+      *tail = timer;
+      tail = &timer->next_expired;
+    } else {
+      link = &timer->next;
+    }
+  }
+
+  /* timers stopped or re-armed by an earlier callback aren't pending */
+  while (expired != NULL) {
+    Timer_t *timer = expired;
+
+    expired = timer->next_expired;
+    if (timer->pending) {
+      timer->pending = 0;
+      timer->callback(timer);
+    }
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * @file    miros_trace.c
+ * @brief   MiROS RAM trace buffer of kernel events and application log records
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_trace.h"
+
+/**
+ * @brief Kernel events whose data is a task's id
+ * */
+#define TRACE_TASK_EVENTS   \
+  ((1UL << MIROS_TRACE_SWITCH) | (1UL << MIROS_TRACE_BLOCK) \
+      | (1UL << MIROS_TRACE_UNBLOCK) | (1UL << MIROS_TRACE_OVERRUN))
+
+static TraceRecord_t Trace_Buffer[MIROS_TRACE_BUFFER_SIZE];
+static uint32_t Trace_Head = 0;     // oldest record
+static uint32_t Trace_Count = 0;
+static uint32_t Trace_Dropped = 0;
+static uint32_t Trace_Mask = MIROS_TRACE_DEFAULT_MASK;
+static uint32_t Trace_IgnoredTask = MIROS_TRACE_NO_TASK;
+
+MIROS_RAMFUNC void MIROS_TraceRecord(uint16_t event, uint16_t data) {
+  uint32_t primask;
+  TraceRecord_t *record;
+
+  if (event < MIROS_TRACE_USER) {
+    if ((event >= MIROS_TRACE_KERNEL_MAX)
+        || ((Trace_Mask & (1UL << event)) == 0)) {
+      return;
+    }
+
+    if (((TRACE_TASK_EVENTS & (1UL << event)) != 0)
+        && (data == Trace_IgnoredTask)) {
+      return;
+    }
+  } else if (event == MIROS_TRACE_RESERVED) {
+    return;
+  }
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  if (Trace_Count < MIROS_TRACE_BUFFER_SIZE) {
+    record = &Trace_Buffer[(Trace_Head + Trace_Count) % MIROS_TRACE_BUFFER_SIZE];
+
+    /* uwTick is read directly, HAL_GetTick() isn't placed in RAM */
+    record->timestamp = uwTick;
+    record->data = data;
+    record->event = event;
+    Trace_Count++;
+  } else {
+    Trace_Dropped++;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+}
+
+uint32_t MIROS_TraceRead(TraceRecord_t *records, uint32_t count) {
+  uint32_t primask;
+  uint32_t read = 0;
+
+  MIROS_CRITICAL_ENTER(primask);
+
+  while ((read < count) && (Trace_Count > 0)) {
+    records[read] = Trace_Buffer[Trace_Head];
+    read++;
+
+    Trace_Head = (Trace_Head + 1) % MIROS_TRACE_BUFFER_SIZE;
+    Trace_Count--;
+  }
+
+  MIROS_CRITICAL_EXIT(primask);
+
+  return read;
+}
+
+uint32_t MIROS_TraceCount(void) {
+  return Trace_Count;
+}
+
+uint32_t MIROS_TraceDropped(void) {
+  return Trace_Dropped;
+}
+
+void MIROS_TraceSetMask(uint32_t mask) {
+  Trace_Mask = mask;
+}
+
+void MIROS_TraceIgnoreTask(uint32_t id) {
+  Trace_IgnoredTask = id;
+}
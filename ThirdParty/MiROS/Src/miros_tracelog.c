@@ -0,0 +1,282 @@
+/******************************************************************************
+ * @file    miros_tracelog.c
+ * @brief   MiROS persistent flash ring of trace records, surviving resets
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_sem.h"
+#include "miros_io.h"
+#include "miros_flash.h"
+#include "miros_trace.h"
+#include "miros_tracelog.h"
+
+/**
+ * @brief Each page is divided into record sized slots, the first slot holds
+ * the page header: sequence number in the timestamp, and the page magic in
+ * the event.
+ * */
+#define TRACELOG_SLOTS              (FLASH_PAGE_SIZE / sizeof(TraceRecord_t))
+#define TRACELOG_PAGE_MAGIC         0x7A6C
+
+#define TRACELOG_ERASED_EVENT       MIROS_TRACE_RESERVED
+#define TRACELOG_ERASED_TIMESTAMP   0xFFFFFFFF
+
+/**
+ * @brief Invalid page sequence number (erased or invalid page)
+ * */
+#define TRACELOG_NO_SEQUENCE        0
+
+#define TRACELOG_NO_PAGE            0xFFFFFFFF
+
+#define TRACELOG_SLOT(page, slot)   \
+  ((const TraceRecord_t*) (MIROS_TRACELOG_FIRST_PAGE \
+      + ((page) * FLASH_PAGE_SIZE) + ((slot) * sizeof(TraceRecord_t))))
+
+static uint32_t Tracelog_Head = TRACELOG_NO_PAGE;
+static uint32_t Tracelog_Sequence = TRACELOG_NO_SEQUENCE;
+static uint32_t Tracelog_Slot = 0;     // next slot to write in head page
+
+/**
+ * @brief Get a page's sequence number
+ *
+ * @return uint32_t: page's sequence number, or #TRACELOG_NO_SEQUENCE if the
+ *    page has no valid header
+ * */
+static uint32_t Tracelog_PageSequence(uint32_t page) {
+  const TraceRecord_t *header = TRACELOG_SLOT(page, 0);
+
+  if ((header->event != TRACELOG_PAGE_MAGIC)
+      || (header->timestamp == TRACELOG_ERASED_TIMESTAMP)) {
+    return TRACELOG_NO_SEQUENCE;
+  }
+  return header->timestamp;
+}
+
+/**
+ * @brief Find the newest page (binary search)
+ *
+ * Only the page after the head can be invalid (it's being erased), all
+ * pages before it have sequence numbers not less than the first page's,
+ * and all pages after it have less sequence numbers.
+ * */
+static uint32_t Tracelog_FindHead(void) {
+  uint32_t first = Tracelog_PageSequence(0);
+  uint32_t low = 0;
+  uint32_t high = MIROS_TRACELOG_NUM_PAGES - 1;
+
+  if (first == TRACELOG_NO_SEQUENCE) {
+    /* empty log, or the first page is being erased after the last one */
+    return (Tracelog_PageSequence(high) == TRACELOG_NO_SEQUENCE) ?
+        TRACELOG_NO_PAGE : high;
+  }
+
+  while (low < high) {
+    uint32_t mid = (low + high + 1) / 2;
+
+    if (Tracelog_PageSequence(mid) >= first) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+
+  return low;
+}
+
+/**
+ * @brief Find the next slot to write in the head page (binary search over
+ * the committed records, followed by erased slots)
+ * */
+static uint32_t Tracelog_FindSlot(uint32_t page) {
+  uint32_t low = 1;
+  uint32_t high = TRACELOG_SLOTS;
+  const TraceRecord_t *record;
+
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+
+    if (TRACELOG_SLOT(page, mid)->event != TRACELOG_ERASED_EVENT) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  /* skip a record that was being programmed when power was lost */
+  if (low < TRACELOG_SLOTS) {
+    record = TRACELOG_SLOT(page, low);
+    if ((record->timestamp != TRACELOG_ERASED_TIMESTAMP)
+        || (record->data != TRACELOG_ERASED_EVENT)) {
+      low++;
+    }
+  }
+
+  return low;
+}
+
+/**
+ * @brief Erase the page after the head (the oldest page), and make it the
+ * head of the log
+ * */
+static HAL_StatusTypeDef Tracelog_OpenPage(void) {
+  TraceRecord_t header;
+  uint32_t page = (Tracelog_Head == TRACELOG_NO_PAGE) ?
+      0 : ((Tracelog_Head + 1) % MIROS_TRACELOG_NUM_PAGES);
+  HAL_StatusTypeDef status;
+
+  status = MIROS_FlashErase(MIROS_TRACELOG_FIRST_PAGE + (page * FLASH_PAGE_SIZE),
+      1);
+  if (status != HAL_OK) {
+    return status;
+  }
+
+  header.timestamp = Tracelog_Sequence + 1;
+  header.data = 0;
+  header.event = TRACELOG_PAGE_MAGIC;
+
+  Tracelog_Head = page;
+  Tracelog_Sequence = header.timestamp;
+  Tracelog_Slot = 1;
+
+  return MIROS_FlashProgram((uint32_t) TRACELOG_SLOT(page, 0),
+      (const uint16_t*) &header, sizeof(header) / sizeof(uint16_t));
+}
+
+void MIROS_TraceLogInitialize(void) {
+  Tracelog_Head = Tracelog_FindHead();
+
+  if (Tracelog_Head != TRACELOG_NO_PAGE) {
+    Tracelog_Sequence = Tracelog_PageSequence(Tracelog_Head);
+    Tracelog_Slot = Tracelog_FindSlot(Tracelog_Head);
+  } else {
+    Tracelog_Sequence = TRACELOG_NO_SEQUENCE;
+    Tracelog_Slot = 0;
+  }
+
+  /* record reset cause, then clear reset flags */
+  MIROS_TraceRecord(MIROS_TRACE_BOOT, (uint16_t) (RCC->CSR >> 24));
+  SET_BIT(RCC->CSR, RCC_CSR_RMVF);
+}
+
+HAL_StatusTypeDef MIROS_TraceLogFlush(void) {
+  TraceRecord_t batch[MIROS_TRACELOG_BATCH_SIZE];
+  HAL_StatusTypeDef result = HAL_OK;
+  HAL_StatusTypeDef status;
+  uint32_t count;
+  uint32_t remaining;
+
+  /* the flushing task blocks on every flash operation, don't log its waits */
+  MIROS_TraceIgnoreTask(MIROS_GetRunningTask()->id);
+
+  /* records added meanwhile are left to the next flush */
+  remaining = MIROS_TraceCount();
+
+  while (remaining > 0) {
+    if ((Tracelog_Head == TRACELOG_NO_PAGE) || (Tracelog_Slot >= TRACELOG_SLOTS)) {
+      status = Tracelog_OpenPage();
+      if (status != HAL_OK) {
+        result = status;
+        break;
+      }
+    }
+
+    count = TRACELOG_SLOTS - Tracelog_Slot;
+    if (count > MIROS_TRACELOG_BATCH_SIZE) {
+      count = MIROS_TRACELOG_BATCH_SIZE;
+    }
+    if (count > remaining) {
+      count = remaining;
+    }
+
+    count = MIROS_TraceRead(batch, count);
+    if (count == 0) {
+      break;
+    }
+    remaining -= count;
+
+    status = MIROS_FlashProgram((uint32_t) TRACELOG_SLOT(Tracelog_Head,
+        Tracelog_Slot), (const uint16_t*) batch,
+        count * (sizeof(TraceRecord_t) / sizeof(uint16_t)));
+    if (status != HAL_OK) {
+      result = status;
+    }
+
+    Tracelog_Slot += count;
+  }
+
+  MIROS_TraceIgnoreTask(MIROS_TRACE_NO_TASK);
+
+  return result;
+}
+
+const TraceRecord_t* MIROS_TraceLogGet(uint32_t age) {
+  const TraceRecord_t *record;
+  uint32_t page = Tracelog_Head;
+  uint32_t slot = Tracelog_Slot;
+  uint32_t sequence = Tracelog_Sequence;
+
+  if (page == TRACELOG_NO_PAGE) {
+    return NULL;
+  }
+
+  for (uint32_t pages = 0; pages < MIROS_TRACELOG_NUM_PAGES; pages++) {
+    while (slot > 1) {
+      slot--;
+      record = TRACELOG_SLOT(page, slot);
+
+      /* skip records that were being programmed when power was lost */
+      if (record->event == TRACELOG_ERASED_EVENT) {
+        continue;
+      }
+
+      if (age == 0) {
+        return record;
+      }
+      age--;
+    }
+
+    /* move to the previous page, if it's older than the current one */
+    page = (page + MIROS_TRACELOG_NUM_PAGES - 1) % MIROS_TRACELOG_NUM_PAGES;
+    sequence--;
+    if ((sequence == TRACELOG_NO_SEQUENCE)
+        || (Tracelog_PageSequence(page) != sequence)) {
+      break;
+    }
+    slot = TRACELOG_SLOTS;
+  }
+
+  return NULL;
+}
+
+void MIROS_TraceLogTask(void) {
+  while (1) {
+    MIROS_TaskDelay(MIROS_TRACELOG_FLUSH_PERIOD);
+    (void) MIROS_TraceLogFlush();
+  }
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * @file    miros_tt.c
+ * @brief   Time-triggered cyclic executive
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "miros_tt.h"
+
+static TIM_HandleTypeDef *Tt_Htim = NULL;
+static uint32_t Tt_Channel = 0;
+static uint32_t Tt_Flag = 0;
+static const TtSchedule_t *Tt_Schedule = NULL;
+
+/**
+ * @brief Index of the next job to be dispatched
+ * */
+static uint32_t Tt_Index = 0;
+
+/**
+ * @brief Timer count of the armed compare
+ * */
+static uint32_t Tt_Compare = 0;
+
+/**
+ * @brief Timer ticks left until the next job, after the armed compare
+ * */
+static uint32_t Tt_Remaining = 0;
+
+static uint32_t Tt_Overruns = 0;
+
+/**
+ * @brief Arm the next compare, @p ticks after the last one
+ *
+ * @param [in] ticks timer ticks until the next job
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Tt_Arm(uint32_t ticks) {
+  uint32_t step = (ticks > MIROS_TT_MAX_STEP) ? MIROS_TT_MAX_STEP : ticks;
+
+  Tt_Remaining = ticks - step;
+  Tt_Compare = (Tt_Compare + step) & MIROS_TT_MAX_STEP;
+  __HAL_TIM_SET_COMPARE(Tt_Htim, Tt_Channel, Tt_Compare);
+}
+
+HAL_StatusTypeDef MIROS_TtStart(TIM_HandleTypeDef *htim, uint32_t channel,
+    const TtSchedule_t *schedule) {
+  assert_param(schedule->num_entries > 0);
+  assert_param(
+      schedule->entries[schedule->num_entries - 1].offset
+          < schedule->hyperperiod);
+
+  Tt_Htim = htim;
+  Tt_Channel = channel;
+  Tt_Flag = TIM_FLAG_CC1 << (channel >> 2);
+  Tt_Schedule = schedule;
+  Tt_Index = 0;
+  Tt_Overruns = 0;
+
+  Tt_Compare = __HAL_TIM_GET_COUNTER(htim);
+  Tt_Arm(MIROS_TT_START_DELAY + schedule->entries[0].offset);
+  __HAL_TIM_CLEAR_FLAG(htim, Tt_Flag);
+
+  return HAL_TIM_OC_Start_IT(htim, channel);
+}
+
+void MIROS_TtStop(void) {
+  if (Tt_Htim != NULL) {
+    (void) HAL_TIM_OC_Stop_IT(Tt_Htim, Tt_Channel);
+    Tt_Htim = NULL;
+  }
+}
+
+uint32_t MIROS_TtOverruns(void) {
+  return Tt_Overruns;
+}
+
+MIROS_RAMFUNC void MIROS_TtIRQHandler(void) {
+  const TtEntry_t *entries;
+  uint32_t index;
+  uint32_t next;
+
+  if ((Tt_Htim == NULL) || !__HAL_TIM_GET_FLAG(Tt_Htim, Tt_Flag)) {
+    return;
+  }
+
+  __HAL_TIM_CLEAR_FLAG(Tt_Htim, Tt_Flag);
+
+  /* intermediate step of a long gap */
+  if (Tt_Remaining > 0) {
+    Tt_Arm(Tt_Remaining);
+    return;
+  }
+
+  /* arm the next job's compare, before running this one */
+  entries = Tt_Schedule->entries;
+  index = Tt_Index;
+  next = index + 1;
+  if (next < Tt_Schedule->num_entries) {
+    Tt_Arm(entries[next].offset - entries[index].offset);
+  } else {
+    next = 0;
+    Tt_Arm(Tt_Schedule->hyperperiod - entries[index].offset
+        + entries[0].offset);
+  }
+  Tt_Index = next;
+
+  entries[index].job();
+
+  /* the next compare already matched while the job was running */
+  if (__HAL_TIM_GET_FLAG(Tt_Htim, Tt_Flag) && (Tt_Remaining == 0)) {
+    Tt_Overruns++;
+  }
+}
@@ -0,0 +1,364 @@
+/******************************************************************************
+ * @file    priority.c
+ * @brief   Preemptive fixed priority scheduler
+ * @author  Mohammad Mohsen
+ * @date    2026/10/18
+ * @version 0.1.0
+ * @license MIT license
+ *          Copyright 2023, Mohammad Mohsen
+ *          Permission is hereby granted, free of charge, to any person
+ *          obtaining a copy of this software and associated documentation files
+ *          (the “Software”), to deal in the Software without restriction,
+ *          including without limitation the rights to use, copy, modify, merge,
+ *          publish, distribute, sublicense, and/or sell copies of the Software,
+ *          and to permit persons to whom the Software is furnished to do so,
+ *          subject to the following conditions:
+ *          The above copyright notice and this permission notice shall be
+ *          included in all copies or substantial portions of the Software.
+ *          THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND,
+ *          EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *          MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *          NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ *          BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ *          ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *          CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *          SOFTWARE.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "miros.h"
+#include "priority.h"
+
+#if MIROS_SCHEDULER == MIROS_SCHED_PRIORITY
+
+/**
+ * @brief Bitmap helpers, bit n of a set is task id (or priority level) n
+ * */
+#define SCHED_BIT(n)                (1UL << (n))
+#define SCHED_HIGHEST(set)          (31UL - __CLZ(set))
+#define SCHED_LOWEST(set)           ((uint32_t)__CLZ(__RBIT(set)))
+
+static Task_t *Sched_Tasks[MIROS_NUM_TASKS] = { 0 };
+
+/**
+ * @brief Ids of the tasks of each priority level
+ * */
+static uint32_t Sched_LevelTasks[MIROS_NUM_PRIORITIES] = { 0 };
+
+/**
+ * @brief Id of the last task selected from each priority level, the next
+ * task of the same level is selected after it
+ * */
+static uint32_t Sched_LastTask[MIROS_NUM_PRIORITIES] = { 0 };
+
+static uint32_t Sched_ReadyTasks = 0;
+static uint32_t Sched_ReadyLevels = 0;
+static uint32_t Sched_SliceExpired = 0;
+
+/**
+ * @brief Tasks that can be scheduled: the active tasks (all tasks, unless
+ * restricted to a time partition), except for the dropped tasks (low
+ * criticality tasks in high criticality mode). Ready levels only account
+ * for the eligible tasks.
+ * */
+static uint32_t Sched_ActiveTasks = 0xFFFFFFFFUL;
+static uint32_t Sched_DroppedTasks = 0;
+static uint32_t Sched_EligibleTasks = 0xFFFFFFFFUL;
+
+static uint32_t Sched_Ceiling = 0;
+static Task_t *Sched_CeilingOwner = NULL;
+
+#if MIROS_FAIR_SHARE
+/**
+ * @brief Virtual runtime of the last selected proportional share task,
+ * tasks that become ready are not allowed to lag behind it
+ * */
+static uint32_t Sched_MinVruntime = 0;
+#endif
+
+/**
+ * @brief Tasks that raised the ceiling to their preemption threshold, and
+ * didn't block yet. And the ceiling each of them replaced.
+ * */
+static uint32_t Sched_StartedTasks = 0;
+static uint32_t Sched_SavedCeiling[MIROS_NUM_TASKS] = { 0 };
+static Task_t *Sched_SavedOwner[MIROS_NUM_TASKS] = { 0 };
+
+/**
+ * @brief Update a level's bit in the ready levels, after a change to its
+ * tasks
+ *
+ * @param [in] level priority level
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Sched_UpdateLevel(uint32_t level) {
+  uint32_t tasks = Sched_ReadyTasks & Sched_EligibleTasks;
+
+  if ((tasks & Sched_LevelTasks[level]) != 0) {
+    Sched_ReadyLevels |= SCHED_BIT(level);
+  } else {
+    Sched_ReadyLevels &= ~SCHED_BIT(level);
+  }
+}
+
+/**
+ * @brief Check whether the system ceiling is set by an eligible task
+ *
+ * @param void
+ *
+ * @return uint32_t: 1 if the ceiling applies, 0 otherwise
+ * */
+MIROS_RAMFUNC static uint32_t Sched_CeilingIsSet(void) {
+  return (Sched_CeilingOwner != NULL)
+      && ((Sched_EligibleTasks & SCHED_BIT(Sched_CeilingOwner->id)) != 0);
+}
+
+#if MIROS_FAIR_SHARE
+/**
+ * @brief Select the task with the lowest virtual runtime
+ *
+ * @param [in] candidates ready tasks of the proportional share level
+ *
+ * @return uint32_t: selected task's id
+ * */
+MIROS_RAMFUNC static uint32_t Sched_SelectFairest(uint32_t candidates) {
+  uint32_t best = SCHED_LOWEST(candidates);
+
+  candidates &= candidates - 1;
+  while (candidates != 0) {
+    uint32_t id = SCHED_LOWEST(candidates);
+
+    /* wrap around safe comparison */
+    if ((int32_t) (Sched_Tasks[id]->vruntime - Sched_Tasks[best]->vruntime)
+        < 0) {
+      best = id;
+    }
+    candidates &= candidates - 1;
+  }
+
+  Sched_MinVruntime = Sched_Tasks[best]->vruntime;
+
+  return best;
+}
+#endif
+
+/**
+ * @brief Raise the ceiling to @p task's preemption threshold, when it's
+ * switched in
+ *
+ * @param [in] task pointer to the selected task
+ *
+ * @return Task_t *: @p task
+ * */
+MIROS_RAMFUNC static Task_t* Sched_StartTask(Task_t *task) {
+  uint32_t id = task->id;
+
+  if ((task->threshold > task->priority)
+      && ((Sched_StartedTasks & SCHED_BIT(id)) == 0)) {
+    Sched_StartedTasks |= SCHED_BIT(id);
+    Sched_SavedCeiling[id] = Sched_Ceiling;
+    Sched_SavedOwner[id] = Sched_CeilingOwner;
+    Sched_Ceiling = task->threshold;
+    Sched_CeilingOwner = task;
+  }
+
+  return task;
+}
+
+void Scheduler_Initialize(void) {
+  for (uint32_t id = 0; id < MIROS_NUM_TASKS; id++) {
+    Sched_Tasks[id] = NULL;
+  }
+
+  for (uint32_t level = 0; level < MIROS_NUM_PRIORITIES; level++) {
+    Sched_LevelTasks[level] = 0;
+    Sched_LastTask[level] = MIROS_NUM_TASKS - 1;
+  }
+
+  Sched_ReadyTasks = 0;
+  Sched_ReadyLevels = 0;
+  Sched_SliceExpired = 0;
+  Sched_ActiveTasks = 0xFFFFFFFFUL;
+  Sched_DroppedTasks = 0;
+  Sched_EligibleTasks = 0xFFFFFFFFUL;
+  Sched_Ceiling = 0;
+  Sched_CeilingOwner = NULL;
+  Sched_StartedTasks = 0;
+#if MIROS_FAIR_SHARE
+  Sched_MinVruntime = 0;
+#endif
+}
+
+void Scheduler_AddTask(Task_t *task) {
+  assert_param(task->id < MIROS_NUM_TASKS);
+  assert_param(task->priority < MIROS_NUM_PRIORITIES);
+
+  Sched_Tasks[task->id] = task;
+  Sched_LevelTasks[task->priority] |= SCHED_BIT(task->id);
+
+  if (task->state == MIROS_TASK_READY) {
+    Sched_ReadyTasks |= SCHED_BIT(task->id);
+    Sched_UpdateLevel(task->priority);
+  }
+}
+
+MIROS_RAMFUNC Task_t* Scheduler_GetTask(void) {
+  Task_t *running = MIROS_GetRunningTask();
+  uint32_t slice_expired = Sched_SliceExpired;
+  uint32_t candidates;
+  uint32_t level;
+  uint32_t id;
+
+  Sched_SliceExpired = 0;
+
+  /* the ceiling's owner runs, unless a task above the ceiling is ready */
+  if (Sched_CeilingIsSet()
+      && (Sched_CeilingOwner->state == MIROS_TASK_READY)) {
+    if ((Sched_ReadyLevels == 0)
+        || (SCHED_HIGHEST(Sched_ReadyLevels) <= Sched_Ceiling)) {
+      return Sched_CeilingOwner;
+    }
+  }
+
+  if (Sched_ReadyLevels == 0) {
+    return NULL;
+  }
+
+  level = SCHED_HIGHEST(Sched_ReadyLevels);
+
+  /* keep the running task until its time slice expires */
+  if ((running != NULL) && (running->id < MIROS_NUM_TASKS)
+      && (running->state == MIROS_TASK_READY) && (running->priority == level)
+      && ((Sched_EligibleTasks & SCHED_BIT(running->id)) != 0)
+      && (slice_expired == 0)) {
+    return running;
+  }
+
+  candidates = Sched_ReadyTasks & Sched_EligibleTasks;
+  candidates &= Sched_LevelTasks[level];
+
+#if MIROS_FAIR_SHARE
+  if (level == MIROS_FAIR_PRIORITY) {
+    id = Sched_SelectFairest(candidates);
+  } else
+#endif
+  {
+    /* next ready task of the same level, after the last selected one */
+    id = Sched_LastTask[level];
+    if ((candidates & ~((SCHED_BIT(id) << 1) - 1)) != 0) {
+      id = SCHED_LOWEST(candidates & ~((SCHED_BIT(id) << 1) - 1));
+    } else {
+      id = SCHED_LOWEST(candidates);
+    }
+  }
+
+  Sched_LastTask[level] = id;
+
+  return Sched_StartTask(Sched_Tasks[id]);
+}
+
+MIROS_RAMFUNC uint32_t Scheduler_ReadyTask(Task_t *task) {
+  Task_t *running = MIROS_GetRunningTask();
+
+  Sched_ReadyTasks |= SCHED_BIT(task->id);
+  Sched_UpdateLevel(task->priority);
+
+#if MIROS_FAIR_SHARE
+  /* a task that was blocked doesn't get the CPU time it missed */
+  if ((task->priority == MIROS_FAIR_PRIORITY)
+      && ((int32_t) (task->vruntime - Sched_MinVruntime) < 0)) {
+    task->vruntime = Sched_MinVruntime;
+  }
+#endif
+
+  if ((Sched_EligibleTasks & SCHED_BIT(task->id)) == 0) {
+    return 0;
+  }
+
+  /* idle task is running */
+  if ((running == NULL) || (running->id >= MIROS_NUM_TASKS)) {
+    return 1;
+  }
+
+  if (Sched_CeilingIsSet() && (task->priority <= Sched_Ceiling)) {
+    return 0;
+  }
+
+  return (task->priority > running->priority);
+}
+
+MIROS_RAMFUNC void Scheduler_BlockTask(Task_t *task) {
+  uint32_t id = task->id;
+
+  /* restore the ceiling the task's threshold replaced */
+  if ((Sched_StartedTasks & SCHED_BIT(id)) != 0) {
+    assert_param(Sched_CeilingOwner == task);
+    Sched_StartedTasks &= ~SCHED_BIT(id);
+    Sched_Ceiling = Sched_SavedCeiling[id];
+    Sched_CeilingOwner = Sched_SavedOwner[id];
+  }
+
+  Sched_ReadyTasks &= ~SCHED_BIT(task->id);
+  Sched_UpdateLevel(task->priority);
+}
+
+MIROS_RAMFUNC void Scheduler_Tick(void) {
+  Sched_SliceExpired = 1;
+}
+
+MIROS_RAMFUNC void Scheduler_SetPriority(Task_t *task, uint32_t priority) {
+  uint32_t id = task->id;
+
+  assert_param(priority < MIROS_NUM_PRIORITIES);
+
+  /* move the task from its level to the new one */
+  Sched_LevelTasks[task->priority] &= ~SCHED_BIT(id);
+  Sched_UpdateLevel(task->priority);
+
+  task->priority = priority;
+
+  Sched_LevelTasks[priority] |= SCHED_BIT(id);
+  Sched_UpdateLevel(priority);
+}
+
+/**
+ * @brief Update the eligible tasks and the ready levels, after a change to
+ * the active or dropped tasks
+ *
+ * @param void
+ *
+ * @return void
+ * */
+MIROS_RAMFUNC static void Sched_UpdateEligible(void) {
+  Sched_EligibleTasks = Sched_ActiveTasks & ~Sched_DroppedTasks;
+
+  for (uint32_t level = 0; level < MIROS_NUM_PRIORITIES; level++) {
+    Sched_UpdateLevel(level);
+  }
+}
+
+MIROS_RAMFUNC void Scheduler_SetActiveTasks(uint32_t tasks) {
+  Sched_ActiveTasks = tasks;
+  Sched_UpdateEligible();
+}
+
+MIROS_RAMFUNC void Scheduler_SetDroppedTasks(uint32_t tasks) {
+  Sched_DroppedTasks = tasks;
+  Sched_UpdateEligible();
+}
+
+void Scheduler_SetCeiling(uint32_t ceiling, Task_t *owner) {
+  Sched_Ceiling = ceiling;
+  Sched_CeilingOwner = owner;
+}
+
+uint32_t Scheduler_GetCeiling(Task_t **owner) {
+  *owner = Sched_CeilingOwner;
+  return Sched_Ceiling;
+}
+
+#endif /* MIROS_SCHEDULER == MIROS_SCHED_PRIORITY */
@@ -32,6 +32,8 @@
 #include "miros.h"
 #include "round_robin.h"
 
+#if MIROS_SCHEDULER == MIROS_SCHED_ROUND_ROBIN
+
 static Task_t *Sched_TaskQueue[MIROS_NUM_TASKS] = { 0 };
 static uint32_t Sched_AddedTasks = 0;    // tail
 static uint32_t Sched_CurrentTaskIndex = 0; // head
@@ -53,18 +55,43 @@ void Scheduler_AddTask(Task_t *task) {
   Sched_AddedTasks++;
 }
 
-Task_t* Scheduler_GetTask(void) {
+MIROS_RAMFUNC Task_t* Scheduler_GetTask(void) {
   Task_t * next_task = NULL;
 
   assert_param(Sched_AddedTasks > 0);
 
-  next_task = Sched_TaskQueue[Sched_CurrentTaskIndex];
+  /* get next ready task from task queue, skipping blocked tasks */
+  for (uint32_t count = 0; count < Sched_AddedTasks; count++) {
+    Task_t *task = Sched_TaskQueue[Sched_CurrentTaskIndex];
+
+    Sched_CurrentTaskIndex++;
+    if (Sched_CurrentTaskIndex == Sched_AddedTasks) {
+      Sched_CurrentTaskIndex = 0;
+    }
 
-  /* get task from task queue */
-  Sched_CurrentTaskIndex++;
-  if (Sched_CurrentTaskIndex == Sched_AddedTasks) {
-    Sched_CurrentTaskIndex = 0;
+    if (task->state == MIROS_TASK_READY) {
+      next_task = task;
+      break;
+    }
   }
 
   return next_task;
 }
+
+MIROS_RAMFUNC uint32_t Scheduler_ReadyTask(Task_t *task) {
+  (void) task;
+  return 0;
+}
+
+MIROS_RAMFUNC void Scheduler_BlockTask(Task_t *task) {
+  (void) task;
+}
+
+MIROS_RAMFUNC void Scheduler_Tick(void) {
+}
+
+MIROS_RAMFUNC void Scheduler_SetPriority(Task_t *task, uint32_t priority) {
+  task->priority = priority;
+}
+
+#endif /* MIROS_SCHEDULER == MIROS_SCHED_ROUND_ROBIN */